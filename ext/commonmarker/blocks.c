@@ -22,6 +22,9 @@
 #include "houdini.h"
 #include "buffer.h"
 #include "footnotes.h"
+#include "deadline.h"
+#include "mem_stats.h"
+#include "probes.h"
 
 #define CODE_INDENT 4
 #define TAB_STOP 4
@@ -113,6 +116,8 @@ static void cmark_parser_reset(cmark_parser *parser) {
   cmark_llist *saved_exts = parser->syntax_extensions;
   cmark_llist *saved_inline_exts = parser->inline_syntax_extensions;
   int saved_options = parser->options;
+  int64_t saved_deadline = parser->deadline;
+  bool saved_timed_out = parser->timed_out;
   cmark_mem *saved_mem = parser->mem;
 
   cmark_parser_dispose(parser);
@@ -132,6 +137,32 @@ static void cmark_parser_reset(cmark_parser *parser) {
   parser->syntax_extensions = saved_exts;
   parser->inline_syntax_extensions = saved_inline_exts;
   parser->options = saved_options;
+  parser->deadline = saved_deadline;
+  parser->timed_out = saved_timed_out;
+  cmark_inlines_reset_special_characters(parser);
+}
+
+// How many calls to cmark_parser_check_deadline share one clock reading.
+#define DEADLINE_CHECK_INTERVAL 32
+
+void cmark_parser_set_deadline(cmark_parser *parser, int64_t deadline) {
+  parser->deadline = deadline;
+  parser->deadline_ticks = 0;
+  parser->timed_out = false;
+}
+
+int cmark_parser_timed_out(cmark_parser *parser) {
+  return parser->timed_out;
+}
+
+bool cmark_parser_check_deadline(cmark_parser *parser) {
+  if (parser->timed_out)
+    return true;
+  if (!parser->deadline ||
+      parser->deadline_ticks++ % DEADLINE_CHECK_INTERVAL != 0)
+    return false;
+  parser->timed_out = cmark_monotonic_ns() >= parser->deadline;
+  return parser->timed_out;
 }
 
 cmark_parser *cmark_parser_new_with_mem(int options, cmark_mem *mem) {
@@ -410,15 +441,16 @@ static cmark_node *add_child(cmark_parser *parser, cmark_node *parent,
 void cmark_manage_extensions_special_characters(cmark_parser *parser, int add) {
   cmark_llist *tmp_ext;
 
+  cmark_inlines_reset_special_characters(parser);
+  if (!add)
+    return;
+
   for (tmp_ext = parser->inline_syntax_extensions; tmp_ext; tmp_ext=tmp_ext->next) {
     cmark_syntax_extension *ext = (cmark_syntax_extension *) tmp_ext->data;
     cmark_llist *tmp_char;
     for (tmp_char = ext->special_inline_chars; tmp_char; tmp_char=tmp_char->next) {
       unsigned char c = (unsigned char)(size_t)tmp_char->data;
-      if (add)
-        cmark_inlines_add_special_character(c, ext->emphasis);
-      else
-        cmark_inlines_remove_special_character(c, ext->emphasis);
+      cmark_inlines_add_special_character(parser, c, ext->emphasis);
     }
   }
 }
@@ -430,12 +462,16 @@ static void process_inlines(cmark_parser *parser,
   cmark_iter *iter = cmark_iter_new(parser->root);
   cmark_node *cur;
   cmark_event_type ev_type;
+  size_t nodes = 0;
 
+  CMARK_PROBE0(inlines__start);
   cmark_manage_extensions_special_characters(parser, true);
 
-  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE &&
+         !parser->timed_out) {
     cur = cmark_iter_get_node(iter);
     if (ev_type == CMARK_EVENT_ENTER) {
+      nodes++;
       if (contains_inlines(cur)) {
         cmark_parse_inlines(parser, cur, refmap, options);
       }
@@ -445,6 +481,7 @@ static void process_inlines(cmark_parser *parser,
   cmark_manage_extensions_special_characters(parser, false);
 
   cmark_iter_free(iter);
+  CMARK_PROBE1(inlines__done, nodes);
 }
 
 static int sort_footnote_by_ix(const void *_a, const void *_b) {
@@ -639,8 +676,13 @@ static cmark_node *finalize_document(cmark_parser *parser) {
   }
 
   finalize(parser, parser->root);
+  if (parser->options & CMARK_OPT_BLOCKS_ONLY)
+    return parser->root;
+
+  cmark_mem_enter_phase(parser->mem, CMARK_MEM_PHASE_INLINES);
   process_inlines(parser, parser->refmap, parser->options);
-  if (parser->options & CMARK_OPT_FOOTNOTES)
+  cmark_mem_enter_phase(parser->mem, CMARK_MEM_PHASE_POSTPROCESS);
+  if ((parser->options & CMARK_OPT_FOOTNOTES) && !parser->timed_out)
     process_footnotes(parser);
 
   return parser->root;
@@ -698,6 +740,9 @@ static void S_parser_feed(cmark_parser *parser, const unsigned char *buffer,
   const unsigned char *end = buffer + len;
   static const uint8_t repl[] = {239, 191, 189};
 
+  CMARK_PROBE1(parse__feed__start, len);
+  cmark_mem_enter_phase(parser->mem, CMARK_MEM_PHASE_BLOCKS);
+
   if (parser->last_buffer_ended_with_cr && *buffer == '\n') {
     // skip NL if last buffer ended with CR ; see #117
     buffer++;
@@ -757,6 +802,8 @@ static void S_parser_feed(cmark_parser *parser, const unsigned char *buffer,
       }
     }
   }
+
+  CMARK_PROBE2(parse__feed__done, len, parser->line_number);
 }
 
 static void chop_trailing_hashtags(cmark_chunk *ch) {
@@ -1430,6 +1477,9 @@ static void S_process_line(cmark_parser *parser, const unsigned char *buffer,
   cmark_chunk input;
   cmark_node *current;
 
+  if (cmark_parser_check_deadline(parser))
+    return;
+
   cmark_strbuf_clear(&parser->curline);
 
   if (parser->options & CMARK_OPT_VALIDATE_UTF8)
@@ -1499,13 +1549,28 @@ cmark_node *cmark_parser_finish(cmark_parser *parser) {
   if (parser->root == NULL)
     return NULL;
 
+  CMARK_PROBE1(parse__finish__start, parser->line_number);
+  cmark_mem_enter_phase(parser->mem, CMARK_MEM_PHASE_BLOCKS);
+
   if (parser->linebuf.size) {
     S_process_line(parser, parser->linebuf.ptr, parser->linebuf.size);
     cmark_strbuf_clear(&parser->linebuf);
   }
 
-  finalize_document(parser);
+  if (!parser->timed_out)
+    finalize_document(parser);
 
+  /* The deadline may also pass while the inlines are parsed. */
+  if (parser->timed_out) {
+    /* Throw away the partial document; resetting frees its nodes. */
+    cmark_strbuf_free(&parser->curline);
+    cmark_strbuf_free(&parser->linebuf);
+    CMARK_PROBE2(parse__finish__done, parser->line_number, 1);
+    cmark_parser_reset(parser);
+    return NULL;
+  }
+
+  cmark_mem_enter_phase(parser->mem, CMARK_MEM_PHASE_POSTPROCESS);
   cmark_consolidate_text_nodes(parser->root);
 
   cmark_strbuf_free(&parser->curline);
@@ -1520,15 +1585,20 @@ cmark_node *cmark_parser_finish(cmark_parser *parser) {
   for (extensions = parser->syntax_extensions; extensions; extensions = extensions->next) {
     cmark_syntax_extension *ext = (cmark_syntax_extension *) extensions->data;
     if (ext->postprocess_func) {
-      cmark_node *processed = ext->postprocess_func(ext, parser, parser->root);
+      cmark_node *processed;
+
+      CMARK_PROBE1(postprocess__start, ext->name);
+      processed = ext->postprocess_func(ext, parser, parser->root);
       if (processed)
         parser->root = processed;
+      CMARK_PROBE1(postprocess__done, ext->name);
     }
   }
 
   res = parser->root;
   parser->root = NULL;
 
+  CMARK_PROBE2(parse__finish__done, parser->line_number, 0);
   cmark_parser_reset(parser);
 
   return res;
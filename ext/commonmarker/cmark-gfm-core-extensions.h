@@ -47,6 +47,29 @@ bool cmark_gfm_extensions_get_tasklist_item_checked(cmark_node *node);
 CMARK_GFM_EXTENSIONS_EXPORT
 int cmark_gfm_extensions_set_tasklist_item_checked(cmark_node *node, bool is_checked);
 
+/** Turns an unresolved mention or issue reference into a link to 'url',
+ * returning 1 on success and 0 on error.
+ */
+CMARK_GFM_EXTENSIONS_EXPORT
+int cmark_gfm_extensions_resolve_mention(cmark_node *node, const char *url);
+
+/** Returns the page a wikilink points to, or NULL if 'node' is not a
+ * wikilink.
+ */
+CMARK_GFM_EXTENSIONS_EXPORT
+const char *cmark_gfm_extensions_get_wikilink_target(cmark_node *node);
+
+/** Returns true if a wikilink has been marked as pointing to a missing page.
+ */
+CMARK_GFM_EXTENSIONS_EXPORT
+bool cmark_gfm_extensions_get_wikilink_missing(cmark_node *node);
+
+/** Marks a wikilink as pointing to a missing page or not, returning 1 on
+ * success and 0 on error.
+ */
+CMARK_GFM_EXTENSIONS_EXPORT
+int cmark_gfm_extensions_set_wikilink_missing(cmark_node *node, bool missing);
+
 #ifdef __cplusplus
 }
 #endif
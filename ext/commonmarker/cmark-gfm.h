@@ -531,6 +531,15 @@ CMARK_GFM_EXPORT void cmark_consolidate_text_nodes(cmark_node *root);
  */
 CMARK_GFM_EXPORT void cmark_node_own(cmark_node *root);
 
+/** Copies the tree under 'root', which must not have a parent, into a
+ * single block of memory in depth-first order, each node followed by its
+ * literal strings, so that traversing and rendering it walks memory in
+ * order. The old tree is freed, along with any pointers into it, and the
+ * copy is returned; it can be used and modified like any other tree.
+ * Returns NULL, leaving the tree alone, if 'root' has a parent.
+ */
+CMARK_GFM_EXPORT cmark_node *cmark_node_compact(cmark_node *root);
+
 /**
  * ## Parsing
  *
@@ -563,6 +572,20 @@ cmark_parser *cmark_parser_new(int options);
 CMARK_GFM_EXPORT
 cmark_parser *cmark_parser_new_with_mem(int options, cmark_mem *mem);
 
+/** Makes the parser give up on the document once the monotonic clock
+ * (CLOCK_MONOTONIC, in nanoseconds) passes 'deadline'; 0 means no deadline.
+ * The clock is checked between lines and between inlines, and once the
+ * deadline has passed 'cmark_parser_finish' frees what was parsed so far
+ * and returns NULL. Setting a new deadline clears 'cmark_parser_timed_out'.
+ */
+CMARK_GFM_EXPORT
+void cmark_parser_set_deadline(cmark_parser *parser, int64_t deadline);
+
+/** Returns 1 if the parser gave up on a document at its deadline.
+ */
+CMARK_GFM_EXPORT
+int cmark_parser_timed_out(cmark_parser *parser);
+
 /** Frees memory allocated for a parser object.
  */
 CMARK_GFM_EXPORT
@@ -622,6 +645,101 @@ char *cmark_render_html(cmark_node *root, int options, cmark_llist *extensions);
 CMARK_GFM_EXPORT
 char *cmark_render_html_with_mem(cmark_node *root, int options, cmark_llist *extensions, cmark_mem *mem);
 
+/** The elements 'cmark_html_attributes' can add attributes to. Links
+ * whose URL has a scheme followed by "//", or that start with "//", get
+ * the EXTERNAL_LINK attributes after the LINK ones. Autolinks are links
+ * too; STRIKETHROUGH and TASK_ITEM are the `<del>` and `<li>` of the
+ * strikethrough and tasklist extensions. MATH_INLINE and MATH_DISPLAY
+ * replace the default attributes of the math extension's wrappers instead
+ * of adding to them: the `<span>` of `$...$`, and the `<span>` of `$$...$$`
+ * or the `<code>` of a math block.
+ */
+typedef enum {
+  CMARK_HTML_ATTRIBUTES_BLOCK_QUOTE,
+  CMARK_HTML_ATTRIBUTES_LIST,
+  CMARK_HTML_ATTRIBUTES_HEADING,
+  CMARK_HTML_ATTRIBUTES_CODE_BLOCK,
+  CMARK_HTML_ATTRIBUTES_PARAGRAPH,
+  CMARK_HTML_ATTRIBUTES_CODE,
+  CMARK_HTML_ATTRIBUTES_LINK,
+  CMARK_HTML_ATTRIBUTES_EXTERNAL_LINK,
+  CMARK_HTML_ATTRIBUTES_IMAGE,
+  CMARK_HTML_ATTRIBUTES_TABLE,
+  CMARK_HTML_ATTRIBUTES_STRIKETHROUGH,
+  CMARK_HTML_ATTRIBUTES_TASK_ITEM,
+  CMARK_HTML_ATTRIBUTES_MATH_INLINE,
+  CMARK_HTML_ATTRIBUTES_MATH_DISPLAY,
+  CMARK_HTML_ATTRIBUTES_COUNT
+} cmark_html_attributes_slot;
+
+/** Extra attributes for the HTML renderer. Each slot is NULL or a string
+ * that is copied verbatim into the opening tag, such as
+ * " class=\"table\""; it must be escaped and start with a space.
+ * 'code_language_prefix' replaces the "language-" prefix of the class of
+ * fenced code, unless it is NULL.
+ */
+typedef struct cmark_html_attributes {
+  const char *slots[CMARK_HTML_ATTRIBUTES_COUNT];
+  const char *code_language_prefix;
+} cmark_html_attributes;
+
+/** As for 'cmark_render_html_with_mem', but adding the given 'attributes'
+ * to the generated elements. 'attributes' may be NULL.
+ */
+CMARK_GFM_EXPORT
+char *cmark_render_html_with_attributes(cmark_node *root, int options,
+                                        cmark_llist *extensions, cmark_mem *mem,
+                                        const cmark_html_attributes *attributes);
+
+/** Receives the output of 'cmark_render_html_stream' piece by piece.
+ * Returning nonzero stops the rendering.
+ */
+typedef int (*cmark_html_flush_func)(const char *data, size_t len,
+                                     void *opaque);
+
+/** As for 'cmark_render_html_with_attributes', but handing the HTML to
+ * 'flush' whenever more than about 'chunk_size' bytes of it have been
+ * rendered, instead of building it up in memory. Returns 0 on success, or
+ * the nonzero value returned by 'flush'.
+ */
+CMARK_GFM_EXPORT
+int cmark_render_html_stream(cmark_node *root, int options,
+                             cmark_llist *extensions, cmark_mem *mem,
+                             const cmark_html_attributes *attributes,
+                             size_t chunk_size, cmark_html_flush_func flush,
+                             void *opaque);
+
+/** Renders HTML a step at a time, so that the caller can do other work in
+ * between. The extensions and attributes passed to
+ * 'cmark_html_stepper_new' must outlive the stepper, and the tree must not
+ * be modified until it is freed.
+ */
+typedef struct cmark_html_stepper cmark_html_stepper;
+
+/** Creates a stepper that renders 'root' like
+ * 'cmark_render_html_with_attributes'. Free it with 'cmark_html_stepper_free'.
+ */
+CMARK_GFM_EXPORT
+cmark_html_stepper *cmark_html_stepper_new(cmark_node *root, int options,
+                                           cmark_llist *extensions,
+                                           cmark_mem *mem,
+                                           const cmark_html_attributes *attributes);
+
+/** Renders up to 'max_nodes' more iterator events, stopping early once
+ * 'max_bytes' of output are pending, and returns the next piece of HTML,
+ * setting 'len' to its length. A piece may be empty; it is only valid until
+ * the next call. Returns NULL once the whole tree has been rendered.
+ */
+CMARK_GFM_EXPORT
+const char *cmark_html_stepper_next(cmark_html_stepper *stepper,
+                                    size_t max_nodes, size_t max_bytes,
+                                    size_t *len);
+
+/** Frees a stepper, whether or not it has finished.
+ */
+CMARK_GFM_EXPORT
+void cmark_html_stepper_free(cmark_html_stepper *stepper);
+
 /** Render a 'node' tree as a groff man page, without the header.
  * It is the caller's responsibility to free the returned buffer.
  */
@@ -752,6 +870,22 @@ char *cmark_render_latex_with_mem(cmark_node *root, int options, int width, cmar
  */
 #define CMARK_OPT_FULL_INFO_STRING (1 << 16)
 
+/** Only parse the block structure of the document: the content of
+ * paragraphs, headings and other leaf blocks is left unparsed, and
+ * footnotes are not resolved.
+ */
+#define CMARK_OPT_BLOCKS_ONLY (1 << 18)
+
+/** Keep the `$` and `$$` delimiters inside the HTML wrappers of math
+ * nodes, for client-side renderers that look for them.
+ */
+#define CMARK_OPT_MATH_DELIMITERS (1 << 19)
+
+/** Leave out the line breaks between block-level HTML elements. The
+ * content of code blocks and raw HTML is kept as it is.
+ */
+#define CMARK_OPT_COMPACT_HTML (1 << 20)
+
 /**
  * ## Version information
  */
@@ -1,14 +1,45 @@
 #include "commonmarker.h"
+#include "ruby/thread.h"
 #include "cmark-gfm.h"
 #include "houdini.h"
 #include "node.h"
 #include "registry.h"
+#include "plugin.h"
 #include "parser.h"
 #include "syntax_extension.h"
 #include "cmark-gfm-core-extensions.h"
+#include "table.h"
+#include "mention.h"
+#include "texmath.h"
+#include "wikilink.h"
+#include "render_cache.h"
+#include "deadline.h"
+#include "mem_stats.h"
+#include "probes.h"
+#include "metrics.h"
+
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_DLOPEN
+#include <dlfcn.h>
+#endif
 
 static VALUE rb_eNodeError;
 static VALUE rb_cNode;
+static VALUE rb_cSharedCache;
+static VALUE rb_eTimeout;
+
+static ID id_source_bytes;
+
+/* Inputs that took longer than the threshold to render, oldest first once
+ * the ring has wrapped around to 'slow_next'. */
+static VALUE slow_inputs;
+static long slow_next;
+static long slow_capacity;
+static size_t slow_max_bytes;
+static int64_t slow_threshold_ns;
 
 static VALUE sym_document;
 static VALUE sym_blockquote;
@@ -38,6 +69,33 @@ static VALUE sym_left;
 static VALUE sym_right;
 static VALUE sym_center;
 
+/* Symbols and IDs for the methods that run on every request. CSTR2SYM
+ * caches each ID in a static the first time it runs, which would make a
+ * forked worker write to a page it shares with its parent. */
+static VALUE sym_start_line;
+static VALUE sym_start_column;
+static VALUE sym_end_line;
+static VALUE sym_end_column;
+static VALUE sym_deflate;
+static VALUE sym_gzip;
+static VALUE sym_total;
+static VALUE sym_checked;
+static VALUE sym_items;
+static VALUE sym_alignments;
+static VALUE sym_table_header;
+static VALUE sym_rows;
+static VALUE sym_input;
+static VALUE sym_input_bytes;
+static VALUE sym_truncated;
+static VALUE sym_digest;
+static VALUE sym_options;
+static VALUE sym_extensions;
+static VALUE sym_parse_ns;
+static VALUE sym_render_ns;
+static VALUE sym_timed_out;
+static VALUE sym_at;
+static ID id_include_p;
+
 static VALUE encode_utf8_string(const char *c_string) {
   VALUE string = rb_str_new2(c_string);
   int enc = rb_enc_find_index("UTF-8");
@@ -115,7 +173,9 @@ static void rb_parent_removed(VALUE val) {
   RDATA(val)->dfree = rb_free_c_struct;
 }
 
-static cmark_parser *prepare_parser(VALUE rb_options, VALUE rb_extensions) {
+static cmark_parser *prepare_parser_with_mem(VALUE rb_options,
+                                             VALUE rb_extensions,
+                                             cmark_mem *mem) {
   int options;
   VALUE rb_ext_name;
   int i;
@@ -125,7 +185,7 @@ static cmark_parser *prepare_parser(VALUE rb_options, VALUE rb_extensions) {
 
   Check_Type(rb_extensions, T_ARRAY);
 
-  cmark_parser *parser = cmark_parser_new(options);
+  cmark_parser *parser = cmark_parser_new_with_mem(options, mem);
 
   for (i = 0; i < RARRAY_LEN(rb_extensions); ++i) {
     rb_ext_name = rb_ary_entry(rb_extensions, i);
@@ -149,33 +209,503 @@ static cmark_parser *prepare_parser(VALUE rb_options, VALUE rb_extensions) {
   return parser;
 }
 
+static cmark_parser *prepare_parser(VALUE rb_options, VALUE rb_extensions) {
+  return prepare_parser_with_mem(rb_options, rb_extensions,
+                                 cmark_get_default_mem_allocator());
+}
+
 /*
- * Internal: Parses a Markdown string into an HTML string.
+ * Internal: Reads an optional deadline on the monotonic clock, in
+ * nanoseconds; nil (no deadline) becomes 0.
+ */
+static int64_t deadline_from_value(VALUE rb_deadline) {
+  return NIL_P(rb_deadline) ? 0 : (int64_t)NUM2LL(rb_deadline);
+}
+
+/*
+ * Internal: The time to measure an operation from, or 0 when neither the
+ * metrics nor the slow input capture need it.
+ */
+static int64_t timing_start(void) {
+  if (!cmark_metrics_enabled() &&
+      !__atomic_load_n(&slow_threshold_ns, __ATOMIC_RELAXED))
+    return 0;
+  return cmark_monotonic_ns();
+}
+
+/*
+ * Internal: Records an operation timed from 'started' in the metrics.
  *
+ * Returns how long it took in nanoseconds, or -1 if it was not timed.
  */
-static VALUE rb_markdown_to_html(VALUE self, VALUE rb_text, VALUE rb_options, VALUE rb_extensions) {
-  char *html;
-  cmark_parser *parser;
-  cmark_node *doc;
+static int64_t timing_record(cmark_metrics_operation operation,
+                             int64_t started, cmark_llist *extensions,
+                             size_t input_bytes) {
+  int64_t elapsed;
+
+  if (!started)
+    return -1;
+
+  elapsed = cmark_monotonic_ns() - started;
+  if (cmark_metrics_enabled())
+    cmark_metrics_record(operation, extensions, input_bytes, elapsed);
+  return elapsed;
+}
 
-  Check_Type(rb_text, T_STRING);
+static VALUE ns_to_value(int64_t ns) { return ns < 0 ? Qnil : LL2NUM(ns); }
 
-  parser = prepare_parser(rb_options, rb_extensions);
+/*
+ * A slow input, copied out of the parser and the text so that the entry
+ * for the ring can be built once they are freed. 'input' is NULL unless
+ * capture_slow_input kept something.
+ */
+struct slow_input {
+  char *input;
+  size_t kept;
+  size_t len;
+  uint64_t digest;
+  int options;
+  const char **extensions;
+  size_t extension_count;
+  int64_t parse_ns;
+  int64_t render_ns;
+  int timed_out;
+  int64_t at_ns;
+};
 
-  cmark_parser_feed(parser, StringValuePtr(rb_text), RSTRING_LEN(rb_text));
+/*
+ * Internal: Copies the start of 'text', the parser's options and extensions
+ * and the phase timings into 'slow', if the phases took longer than the
+ * threshold together or the deadline passed. A phase that did not run or
+ * was not timed has a time of -1. Touches no Ruby object; record_slow_input
+ * adds the entry later.
+ */
+static void capture_slow_input(struct slow_input *slow, const char *text,
+                               size_t len, cmark_parser *parser,
+                               int64_t parse_ns, int64_t render_ns,
+                               int timed_out) {
+  cmark_llist *it;
+  size_t i;
+
+  memset(slow, 0, sizeof(*slow));
+  if (!slow_threshold_ns || parse_ns < 0)
+    return;
+  if (!timed_out && parse_ns + (render_ns > 0 ? render_ns : 0) < slow_threshold_ns)
+    return;
+
+  slow->kept = len < slow_max_bytes ? len : slow_max_bytes;
+  /* Don't cut a UTF-8 sequence in half. */
+  while (slow->kept > 0 && slow->kept < len &&
+         ((unsigned char)text[slow->kept] & 0xC0) == 0x80)
+    slow->kept--;
+  slow->input = (char *)malloc(slow->kept + 1);
+  if (slow->input == NULL)
+    return;
+  memcpy(slow->input, text, slow->kept);
+
+  slow->digest = 0xcbf29ce484222325ULL;
+  for (i = 0; i < len; i++)
+    slow->digest = (slow->digest ^ (unsigned char)text[i]) * 0x100000001b3ULL;
+
+  /* Extensions are registered for the life of the process, so their names
+   * outlive the parser. */
+  for (it = parser->syntax_extensions; it; it = it->next)
+    slow->extension_count++;
+  slow->extensions =
+      (const char **)calloc(slow->extension_count + 1, sizeof(const char *));
+  if (slow->extensions == NULL) {
+    free(slow->input);
+    slow->input = NULL;
+    return;
+  }
+  for (i = 0, it = parser->syntax_extensions; it; it = it->next, i++)
+    slow->extensions[i] = ((cmark_syntax_extension *)it->data)->name;
+
+  slow->len = len;
+  slow->options = parser->options;
+  slow->parse_ns = parse_ns;
+  slow->render_ns = render_ns;
+  slow->timed_out = timed_out;
+  slow->at_ns = cmark_realtime_ns();
+}
+
+static VALUE build_slow_input(VALUE data) {
+  struct slow_input *slow = (struct slow_input *)data;
+  VALUE entry, extensions;
+  char digest_hex[17];
+  size_t i;
+
+  snprintf(digest_hex, sizeof(digest_hex), "%016llx",
+           (unsigned long long)slow->digest);
+
+  extensions = rb_ary_new_capa((long)slow->extension_count);
+  for (i = 0; i < slow->extension_count; i++)
+    rb_ary_push(extensions, CSTR2SYM(slow->extensions[i]));
+
+  entry = rb_hash_new();
+  rb_hash_aset(entry, sym_input, rb_utf8_str_new(slow->input, slow->kept));
+  rb_hash_aset(entry, sym_input_bytes, SIZET2NUM(slow->len));
+  rb_hash_aset(entry, sym_truncated, slow->kept < slow->len ? Qtrue : Qfalse);
+  rb_hash_aset(entry, sym_digest, rb_str_new_cstr(digest_hex));
+  rb_hash_aset(entry, sym_options, INT2NUM(slow->options));
+  rb_hash_aset(entry, sym_extensions, extensions);
+  rb_hash_aset(entry, sym_parse_ns, ns_to_value(slow->parse_ns));
+  rb_hash_aset(entry, sym_render_ns, ns_to_value(slow->render_ns));
+  rb_hash_aset(entry, sym_timed_out, slow->timed_out ? Qtrue : Qfalse);
+  rb_hash_aset(entry, sym_at,
+               rb_time_nano_new((time_t)(slow->at_ns / 1000000000),
+                                (long)(slow->at_ns % 1000000000)));
+
+  if (RARRAY_LEN(slow_inputs) < slow_capacity)
+    rb_ary_push(slow_inputs, entry);
+  else
+    rb_ary_store(slow_inputs, slow_next, entry);
+  slow_next = (slow_next + 1) % slow_capacity;
+  return Qnil;
+}
+
+static VALUE free_slow_input(VALUE data) {
+  struct slow_input *slow = (struct slow_input *)data;
+
+  free(slow->input);
+  free((void *)slow->extensions);
+  slow->input = NULL;
+  slow->extensions = NULL;
+  return Qnil;
+}
+
+/*
+ * Internal: Adds what capture_slow_input kept, if anything, to the slow
+ * input ring. Call it once the parser and any output buffers are freed.
+ */
+static void record_slow_input(struct slow_input *slow) {
+  if (slow->input == NULL)
+    return;
+  rb_ensure(build_slow_input, (VALUE)slow, free_slow_input, (VALUE)slow);
+}
+
+/*
+ * Internal: The size of the Markdown that 'rb_node' was parsed from, if it
+ * is a document parsed while the metrics were on, and otherwise the size of
+ * its output, 'output_bytes'.
+ */
+static size_t metrics_input_bytes(VALUE rb_node, size_t output_bytes) {
+  VALUE rb_bytes = rb_attr_get(rb_node, id_source_bytes);
+
+  return NIL_P(rb_bytes) ? output_bytes : NUM2SIZET(rb_bytes);
+}
+
+/*
+ * Internal: Parses 'text', giving up at 'deadline'. Frees the parser and
+ * raises if no document comes out. Sets '*parse_ns' to how long it took, or
+ * -1 if it was not timed.
+ */
+static cmark_node *parse_before(cmark_parser *parser, const char *text,
+                                size_t len, int64_t deadline,
+                                int64_t *parse_ns) {
+  cmark_node *doc;
+  int64_t started = timing_start(), elapsed;
+
+  cmark_parser_set_deadline(parser, deadline);
+  cmark_parser_feed(parser, text, len);
   doc = cmark_parser_finish(parser);
 
   if (doc == NULL) {
+    int timed_out = cmark_parser_timed_out(parser);
+    struct slow_input slow;
+
+    capture_slow_input(&slow, text, len, parser,
+                       timed_out && started ? cmark_monotonic_ns() - started
+                                            : -1,
+                       -1, 1);
     cmark_parser_free(parser);
+    record_slow_input(&slow);
+    if (timed_out) {
+      rb_raise(rb_eTimeout, "parsing took too long");
+    }
     rb_raise(rb_eNodeError, "error parsing document");
   }
 
-  html = cmark_render_html(doc, parser->options, parser->syntax_extensions);
+  elapsed = timing_record(CMARK_METRICS_PARSE, started,
+                          parser->syntax_extensions, len);
+  if (parse_ns)
+    *parse_ns = elapsed;
+  return doc;
+}
+
+#define DEADLINE_CHUNK_SIZE (4 * 1024)
+
+/* Nothing may raise inside cmark_render_html_stream, so the output is only
+ * turned into a String once it returns. */
+struct deadline_output {
+  cmark_strbuf html;
+  int64_t deadline;
+};
+
+static int append_before_deadline(const char *data, size_t len, void *opaque) {
+  struct deadline_output *output = (struct deadline_output *)opaque;
+
+  cmark_strbuf_put(&output->html, (const unsigned char *)data, (bufsize_t)len);
+  return cmark_monotonic_ns() >= output->deadline;
+}
+
+/*
+ * Internal: Renders 'node' to an HTML String. With a deadline, the output
+ * is rendered a few kilobytes at a time, checking the clock in between.
+ *
+ * Returns the String, or nil if the deadline passed first.
+ */
+static VALUE render_html_before(cmark_node *node, int options,
+                                cmark_llist *extensions,
+                                const cmark_html_attributes *attributes,
+                                int64_t deadline) {
+  struct deadline_output output;
+  char *html;
+  VALUE ruby_html;
+
+  if (!deadline) {
+    html = cmark_render_html_with_attributes(node, options, extensions,
+                                             cmark_node_mem(node), attributes);
+    ruby_html = rb_utf8_str_new_cstr(html);
+    free(html);
+    return ruby_html;
+  }
+
+  cmark_strbuf_init(cmark_node_mem(node), &output.html, DEADLINE_CHUNK_SIZE);
+  output.deadline = deadline;
+  if (cmark_render_html_stream(node, options, extensions, cmark_node_mem(node),
+                               attributes, DEADLINE_CHUNK_SIZE,
+                               append_before_deadline, &output)) {
+    cmark_strbuf_free(&output.html);
+    return Qnil;
+  }
+
+  ruby_html = rb_utf8_str_new((const char *)output.html.ptr, output.html.size);
+  cmark_strbuf_free(&output.html);
+  return ruby_html;
+}
+
+struct html_without_gvl {
+  cmark_parser *parser;
+  char *text;
+  size_t len;
+  int64_t deadline;
+  cmark_strbuf html;
+  int started;
+  int parsed;
+  int timed_out;
+  volatile int cancelled;
+  int64_t parse_ns;
+  int64_t render_ns;
+  struct slow_input slow;
+};
+
+static int append_to_strbuf(const char *data, size_t len, void *opaque) {
+  struct html_without_gvl *args = (struct html_without_gvl *)opaque;
+
+  cmark_strbuf_put(&args->html, (const unsigned char *)data, (bufsize_t)len);
+  return args->cancelled ||
+         (args->deadline && cmark_monotonic_ns() >= args->deadline);
+}
+
+/*
+ * Internal: Parses and renders without touching any Ruby object, so that
+ * it can run with the GVL released. Leaves the HTML in 'args->html'.
+ */
+static void *render_html_without_gvl(void *data) {
+  struct html_without_gvl *args = (struct html_without_gvl *)data;
+  cmark_parser *parser = args->parser;
+  cmark_node *doc;
+  int64_t started = timing_start();
+
+  args->started = 1;
+  cmark_parser_feed(parser, args->text, args->len);
+  doc = cmark_parser_finish(parser);
+
+  if (doc == NULL) {
+    args->timed_out = cmark_parser_timed_out(parser);
+    if (started)
+      args->parse_ns = cmark_monotonic_ns() - started;
+    return NULL;
+  }
+  args->parsed = 1;
+  args->parse_ns = timing_record(CMARK_METRICS_PARSE, started,
+                                 parser->syntax_extensions, args->len);
+
+  started = timing_start();
+  if (cmark_render_html_stream(doc, parser->options, parser->syntax_extensions,
+                               parser->mem, NULL, DEADLINE_CHUNK_SIZE,
+                               append_to_strbuf, args)) {
+    args->timed_out = 1;
+    if (started)
+      args->render_ns = cmark_monotonic_ns() - started;
+  } else {
+    args->render_ns = timing_record(CMARK_METRICS_RENDER, started,
+                                    parser->syntax_extensions, args->len);
+  }
+
+  cmark_node_free(doc);
+  return NULL;
+}
+
+/*
+ * Internal: Called by Ruby, from another thread, when the thread running
+ * render_html_without_gvl is interrupted (Thread#raise, Thread#kill, a
+ * signal). Trips the same flags a passed deadline would, so that the parse
+ * or render stops at its next check instead of running to completion.
+ */
+static void cancel_render_html_without_gvl(void *data) {
+  struct html_without_gvl *args = (struct html_without_gvl *)data;
+
+  args->cancelled = 1;
+  args->parser->timed_out = true;
+}
+
+/*
+ * Internal: Swaps in a fresh parser with the same options and extensions,
+ * and drops any output, so that a cancelled render can start over.
+ */
+static void restart_html_without_gvl(struct html_without_gvl *args) {
+  cmark_parser *old = args->parser;
+  cmark_parser *parser = cmark_parser_new_with_mem(old->options, old->mem);
+  cmark_llist *tmp;
+
+  for (tmp = old->syntax_extensions; tmp; tmp = tmp->next)
+    cmark_parser_attach_syntax_extension(parser,
+                                         (cmark_syntax_extension *)tmp->data);
+  cmark_parser_free(old);
+
+  args->parser = parser;
+  cmark_parser_set_deadline(parser, args->deadline);
+  cmark_strbuf_clear(&args->html);
+  args->started = args->parsed = args->timed_out = args->cancelled = 0;
+  args->parse_ns = args->render_ns = -1;
+}
+
+/*
+ * Internal: Runs the render with the GVL released. Returns the HTML, or nil
+ * if the parse or the render failed.
+ */
+static VALUE finish_html_without_gvl(VALUE data) {
+  struct html_without_gvl *args = (struct html_without_gvl *)data;
+  VALUE ruby_html = Qnil;
+
+  for (;;) {
+    rb_thread_call_without_gvl2(render_html_without_gvl, args,
+                                cancel_render_html_without_gvl, args);
+    if (args->started && !args->cancelled)
+      break;
+
+    /* An interrupt kept the work from starting or cut it short. Let Ruby
+     * handle it now, while rb_ensure still guards the C state; if it does
+     * not raise (a trap handler, a wakeup), go again from the top. */
+    rb_thread_check_ints();
+    if (args->started)
+      restart_html_without_gvl(args);
+  }
+
+  if (args->parsed && !args->timed_out)
+    ruby_html = rb_utf8_str_new((const char *)args->html.ptr, args->html.size);
+  capture_slow_input(&args->slow, args->text, args->len, args->parser,
+                     args->parse_ns, args->render_ns, args->timed_out);
+  return ruby_html;
+}
+
+static VALUE free_html_without_gvl(VALUE data) {
+  struct html_without_gvl *args = (struct html_without_gvl *)data;
+  cmark_mem *mem = args->parser->mem;
+
+  cmark_strbuf_free(&args->html);
+  mem->free(args->text);
+  cmark_parser_free(args->parser);
+  return Qnil;
+}
+
+/*
+ * Internal: Parses a Markdown string into an HTML string, with the GVL
+ * released so that other threads can run meanwhile. Takes ownership of
+ * 'parser'.
+ */
+static VALUE markdown_to_html_without_gvl(VALUE rb_text, cmark_parser *parser,
+                                          int64_t deadline) {
+  struct html_without_gvl args;
+  cmark_mem *mem = parser->mem;
+  VALUE ruby_html;
+
+  memset(&args, 0, sizeof(args));
+  /* Other threads may modify or move the String while the GVL is free. */
+  args.len = RSTRING_LEN(rb_text);
+  args.text = (char *)mem->calloc(args.len + 1, 1);
+  memcpy(args.text, RSTRING_PTR(rb_text), args.len);
+  args.parser = parser;
+  args.deadline = deadline;
+  args.parse_ns = -1;
+  args.render_ns = -1;
+  cmark_strbuf_init(mem, &args.html, 0);
+  /* Set before the GVL is released, so an early interrupt is not reset. */
+  cmark_parser_set_deadline(parser, deadline);
+
+  ruby_html = rb_ensure(finish_html_without_gvl, (VALUE)&args,
+                        free_html_without_gvl, (VALUE)&args);
+  record_slow_input(&args.slow);
+
+  if (args.timed_out)
+    rb_raise(rb_eTimeout, "rendering took too long");
+  if (!args.parsed)
+    rb_raise(rb_eNodeError, "error parsing document");
+  return ruby_html;
+}
+
+/*
+ * Internal: Parses a Markdown string into an HTML string.
+ *
+ * deadline - An optional {Integer} time of the monotonic clock, in
+ *            nanoseconds, after which to give up and raise Timeout
+ * release_gvl - Whether to let other threads run while the text is parsed
+ *               and rendered; the text is copied first
+ */
+static VALUE rb_markdown_to_html(int argc, VALUE *argv, VALUE self) {
+  VALUE rb_text, rb_options, rb_extensions, rb_deadline, rb_release_gvl;
+  VALUE ruby_html;
+  cmark_parser *parser;
+  cmark_node *doc;
+  int64_t deadline, started, parse_ns, render_ns;
+  struct slow_input slow;
+
+  rb_scan_args(argc, argv, "32", &rb_text, &rb_options, &rb_extensions,
+               &rb_deadline, &rb_release_gvl);
+
+  Check_Type(rb_text, T_STRING);
+  deadline = deadline_from_value(rb_deadline);
+
+  parser = prepare_parser(rb_options, rb_extensions);
+
+  if (RTEST(rb_release_gvl))
+    return markdown_to_html_without_gvl(rb_text, parser, deadline);
+
+  doc = parse_before(parser, StringValuePtr(rb_text), RSTRING_LEN(rb_text),
+                     deadline, &parse_ns);
+
+  started = timing_start();
+  ruby_html = render_html_before(doc, parser->options,
+                                 parser->syntax_extensions, NULL, deadline);
+  if (NIL_P(ruby_html))
+    render_ns = started ? cmark_monotonic_ns() - started : -1;
+  else
+    render_ns = timing_record(CMARK_METRICS_RENDER, started,
+                              parser->syntax_extensions, RSTRING_LEN(rb_text));
+  capture_slow_input(&slow, RSTRING_PTR(rb_text), RSTRING_LEN(rb_text), parser,
+                     parse_ns, render_ns, NIL_P(ruby_html));
 
   cmark_parser_free(parser);
   cmark_node_free(doc);
+  record_slow_input(&slow);
+
+  if (NIL_P(ruby_html)) {
+    rb_raise(rb_eTimeout, "rendering took too long");
+  }
 
-  return rb_utf8_str_new_cstr(html);
+  return ruby_html;
 }
 
 /*
@@ -191,13 +721,8 @@ static VALUE rb_markdown_to_xml(VALUE self, VALUE rb_text, VALUE rb_options, VAL
 
   parser = prepare_parser(rb_options, rb_extensions);
 
-  cmark_parser_feed(parser, StringValuePtr(rb_text), RSTRING_LEN(rb_text));
-  doc = cmark_parser_finish(parser);
-
-  if (doc == NULL) {
-    cmark_parser_free(parser);
-    rb_raise(rb_eNodeError, "error parsing document");
-  }
+  doc = parse_before(parser, StringValuePtr(rb_text), RSTRING_LEN(rb_text), 0,
+                     NULL);
 
   xml = cmark_render_xml(doc, parser->options);
 
@@ -289,32 +814,276 @@ static VALUE rb_node_new(VALUE self, VALUE type) {
 }
 
 /*
- * Internal: Parses a Markdown string into a document.
+ * Internal: Parses a Markdown string into a document, compacting the tree
+ * into one block of memory if `compact` is set.
  *
  */
-static VALUE rb_parse_document(VALUE self, VALUE rb_text, VALUE rb_len,
-                               VALUE rb_options, VALUE rb_extensions) {
-  char *text;
-  int len;
+static VALUE rb_parse_document(int argc, VALUE *argv, VALUE self) {
+  VALUE rb_text, rb_len, rb_options, rb_extensions, rb_deadline, rb_compact,
+      rb_doc;
   cmark_parser *parser;
   cmark_node *doc;
+  int64_t parse_ns;
+  struct slow_input slow;
+
+  rb_scan_args(argc, argv, "42", &rb_text, &rb_len, &rb_options,
+               &rb_extensions, &rb_deadline, &rb_compact);
+
   Check_Type(rb_text, T_STRING);
   Check_Type(rb_len, T_FIXNUM);
   Check_Type(rb_options, T_FIXNUM);
 
   parser = prepare_parser(rb_options, rb_extensions);
 
-  text = (char *)RSTRING_PTR(rb_text);
-  len = FIX2INT(rb_len);
+  doc = parse_before(parser, RSTRING_PTR(rb_text), FIX2INT(rb_len),
+                     deadline_from_value(rb_deadline), &parse_ns);
+  capture_slow_input(&slow, RSTRING_PTR(rb_text), FIX2INT(rb_len), parser,
+                     parse_ns, -1, 0);
+  cmark_parser_free(parser);
 
-  cmark_parser_feed(parser, text, len);
-  doc = cmark_parser_finish(parser);
-  if (doc == NULL) {
-    rb_raise(rb_eNodeError, "error parsing document");
+  /* Nothing can point into the tree before it is wrapped. */
+  if (RTEST(rb_compact))
+    doc = cmark_node_compact(doc);
+
+  rb_doc = rb_node_to_value(doc);
+  /* Rendering it later is measured against the size of the Markdown. */
+  if (cmark_metrics_enabled())
+    rb_ivar_set(rb_doc, id_source_bytes, rb_len);
+  record_slow_input(&slow);
+  return rb_doc;
+}
+
+static VALUE mem_phase_stats_to_hash(const cmark_mem_phase_stats *stats) {
+  VALUE result = rb_hash_new();
+
+  rb_hash_aset(result, CSTR2SYM("allocs"), ULL2NUM(stats->allocs));
+  rb_hash_aset(result, CSTR2SYM("reallocs"), ULL2NUM(stats->reallocs));
+  rb_hash_aset(result, CSTR2SYM("frees"), ULL2NUM(stats->frees));
+  rb_hash_aset(result, CSTR2SYM("bytes"), ULL2NUM(stats->bytes));
+  rb_hash_aset(result, CSTR2SYM("peak_live"), ULL2NUM(stats->peak_live));
+  return result;
+}
+
+/*
+ * Internal: Parses and renders a Markdown string to HTML through a counting
+ * allocator, and reports where the native memory went.
+ *
+ * Returns a {Hash} of the allocation counters for each phase under
+ * `:phases`, the overall `:peak_live` bytes, under `:node_types` the
+ * number of nodes of each type and the bytes they held once parsed, and
+ * the HTML under `:output`.
+ */
+static VALUE rb_memory_profile(VALUE self, VALUE rb_text, VALUE rb_options,
+                               VALUE rb_extensions) {
+  static const char *const phase_names[CMARK_MEM_PHASE_COUNT] = {
+      "blocks", "inlines", "postprocess", "render"};
+  cmark_mem *mem = cmark_counting_mem_allocator();
+  cmark_mem *default_mem = cmark_get_default_mem_allocator();
+  const cmark_mem_stats *stats = cmark_counting_mem_stats();
+  cmark_parser *parser;
+  cmark_node *doc, *node;
+  cmark_iter *iter;
+  cmark_event_type ev_type;
+  cmark_llist *extensions = NULL, *it;
+  char *html;
+  VALUE result, phases, node_types, type, entry, output;
+  uint64_t retained;
+  int i, options;
+
+  Check_Type(rb_text, T_STRING);
+
+  cmark_counting_mem_reset();
+  parser = prepare_parser_with_mem(rb_options, rb_extensions, mem);
+  doc = parse_before(parser, RSTRING_PTR(rb_text), RSTRING_LEN(rb_text), 0,
+                     NULL);
+
+  node_types = rb_hash_new();
+  iter = cmark_iter_new(doc);
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    if (ev_type == CMARK_EVENT_EXIT)
+      continue;
+    node = cmark_iter_get_node(iter);
+    type = CSTR2SYM(cmark_node_get_type_string(node));
+    entry = rb_hash_aref(node_types, type);
+    if (NIL_P(entry)) {
+      entry = rb_hash_new();
+      rb_hash_aset(entry, CSTR2SYM("count"), INT2FIX(0));
+      rb_hash_aset(entry, CSTR2SYM("bytes"), INT2FIX(0));
+      rb_hash_aset(node_types, type, entry);
+    }
+    rb_hash_aset(entry, CSTR2SYM("count"),
+                 LONG2NUM(NUM2LONG(rb_hash_aref(entry, CSTR2SYM("count"))) + 1));
+    rb_hash_aset(entry, CSTR2SYM("bytes"),
+                 SIZET2NUM(NUM2SIZET(rb_hash_aref(entry, CSTR2SYM("bytes"))) +
+                           cmark_node_retained_bytes(node)));
   }
+  cmark_iter_free(iter);
+
+  /* Free the parser before rendering, keeping a copy of its extension list
+   * outside the counting allocator, so that what is left live is the tree. */
+  for (it = parser->syntax_extensions; it; it = it->next)
+    extensions = cmark_llist_append(default_mem, extensions, it->data);
+  options = parser->options;
   cmark_parser_free(parser);
+  retained = stats->live;
+
+  html = cmark_render_html_with_mem(doc, options, extensions, mem);
+  output = rb_hash_new();
+  rb_hash_aset(output, CSTR2SYM("html"), rb_utf8_str_new_cstr(html));
+  rb_hash_aset(output, CSTR2SYM("bytes"), SIZET2NUM(strlen(html)));
+  rb_hash_aset(output, CSTR2SYM("allocated"),
+               SIZET2NUM(cmark_counting_mem_size(html)));
+  mem->free(html);
+  cmark_node_free(doc);
+  cmark_llist_free(default_mem, extensions);
+
+  phases = rb_hash_new();
+  for (i = 0; i < CMARK_MEM_PHASE_COUNT; ++i) {
+    rb_hash_aset(phases, CSTR2SYM(phase_names[i]),
+                 mem_phase_stats_to_hash(&stats->phases[i]));
+  }
+
+  result = rb_hash_new();
+  rb_hash_aset(result, CSTR2SYM("phases"), phases);
+  rb_hash_aset(result, CSTR2SYM("peak_live"), ULL2NUM(stats->peak_live));
+  rb_hash_aset(result, CSTR2SYM("retained"), ULL2NUM(retained));
+  rb_hash_aset(result, CSTR2SYM("node_types"), node_types);
+  rb_hash_aset(result, CSTR2SYM("output"), output);
+  return result;
+}
+
+static VALUE metrics_histogram_to_hash(const cmark_metrics_histogram *histogram) {
+  VALUE buckets = rb_ary_new(), hash = rb_hash_new();
+  int i;
+
+  for (i = 0; i < CMARK_METRICS_BUCKETS; ++i) {
+    if (!histogram->buckets[i])
+      continue;
+    rb_ary_push(buckets,
+                rb_ary_new3(3, ULL2NUM(cmark_metrics_bucket_min(i)),
+                            i + 1 < CMARK_METRICS_BUCKETS
+                                ? ULL2NUM(cmark_metrics_bucket_min(i + 1))
+                                : Qnil,
+                            ULL2NUM(histogram->buckets[i])));
+  }
+
+  rb_hash_aset(hash, CSTR2SYM("count"), ULL2NUM(histogram->count));
+  rb_hash_aset(hash, CSTR2SYM("total_ns"), ULL2NUM(histogram->total_ns));
+  rb_hash_aset(hash, CSTR2SYM("max_ns"), ULL2NUM(histogram->max_ns));
+  rb_hash_aset(hash, CSTR2SYM("buckets"), buckets);
+  return hash;
+}
+
+/*
+ * Internal: Reads the latency histograms, zeroing them as they are read if
+ * 'rb_reset' is true.
+ */
+static VALUE rb_metrics(VALUE self, VALUE rb_reset) {
+  static const char *const operation_names[CMARK_METRICS_OPERATIONS] = {
+      "parse", "render"};
+  cmark_metrics_histogram histogram;
+  cmark_metrics_series *series;
+  VALUE all = rb_ary_new(), result, entry, extensions;
+  int reset = RTEST(rb_reset), operation, size_class;
+  size_t slot;
+
+  for (slot = 0; slot < CMARK_METRICS_MAX_SERIES; ++slot) {
+    series = cmark_metrics_series_at(slot);
+    if (!series)
+      continue;
+
+    extensions = rb_ary_new();
+    if (series->extensions && *series->extensions) {
+      VALUE names = rb_str_split(rb_str_new_cstr(series->extensions), ",");
+      long i;
+
+      for (i = 0; i < RARRAY_LEN(names); ++i)
+        rb_ary_push(extensions, rb_str_intern(rb_ary_entry(names, i)));
+    }
+
+    for (operation = 0; operation < CMARK_METRICS_OPERATIONS; ++operation) {
+      for (size_class = 0; size_class < CMARK_METRICS_SIZE_CLASSES;
+           ++size_class) {
+        cmark_metrics_read(&series->histograms[operation][size_class],
+                           &histogram, reset);
+        if (!histogram.count)
+          continue;
+
+        entry = metrics_histogram_to_hash(&histogram);
+        rb_hash_aset(entry, CSTR2SYM("operation"),
+                     CSTR2SYM(operation_names[operation]));
+        rb_hash_aset(entry, CSTR2SYM("extensions"), extensions);
+        rb_hash_aset(entry, CSTR2SYM("min_bytes"),
+                     SIZET2NUM(cmark_metrics_size_class_min(size_class)));
+        rb_hash_aset(entry, CSTR2SYM("max_bytes"),
+                     size_class + 1 < CMARK_METRICS_SIZE_CLASSES
+                         ? SIZET2NUM(cmark_metrics_size_class_min(size_class + 1))
+                         : Qnil);
+        rb_ary_push(all, entry);
+      }
+    }
+  }
+
+  result = rb_hash_new();
+  rb_hash_aset(result, CSTR2SYM("series"), all);
+  rb_hash_aset(result, CSTR2SYM("dropped"), ULL2NUM(cmark_metrics_dropped(reset)));
+  return result;
+}
+
+/*
+ * Internal: Starts keeping the inputs that take longer than 'rb_threshold'
+ * nanoseconds to render, up to 'rb_capacity' of them and 'rb_max_bytes' of
+ * each, or stops with a nil threshold. Drops what was kept so far.
+ */
+static VALUE rb_capture_slow_inputs(VALUE self, VALUE rb_threshold,
+                                    VALUE rb_capacity, VALUE rb_max_bytes) {
+  int64_t threshold = NIL_P(rb_threshold) ? 0 : (int64_t)NUM2LL(rb_threshold);
+  long capacity = NUM2LONG(rb_capacity);
+
+  if (threshold < 0)
+    rb_raise(rb_eArgError, "threshold must not be negative");
+  if (capacity < 1)
+    rb_raise(rb_eArgError, "capacity must be positive");
+
+  slow_max_bytes = NUM2SIZET(rb_max_bytes);
+  slow_capacity = capacity;
+  slow_next = 0;
+  rb_ary_clear(slow_inputs);
+  /* Zero means "off", so a zero threshold catches everything from 1ns. */
+  if (!NIL_P(rb_threshold) && threshold == 0)
+    threshold = 1;
+  __atomic_store_n(&slow_threshold_ns, threshold, __ATOMIC_RELAXED);
+  return Qnil;
+}
+
+/*
+ * Internal: Returns the captured slow inputs, oldest first, emptying the
+ * ring if 'rb_clear' is true.
+ */
+static VALUE rb_slow_inputs(VALUE self, VALUE rb_clear) {
+  VALUE inputs;
+
+  if (RARRAY_LEN(slow_inputs) < slow_capacity) {
+    inputs = rb_ary_dup(slow_inputs);
+  } else {
+    inputs = rb_ary_subseq(slow_inputs, slow_next, slow_capacity - slow_next);
+    rb_ary_concat(inputs, rb_ary_subseq(slow_inputs, 0, slow_next));
+  }
+
+  if (RTEST(rb_clear)) {
+    rb_ary_clear(slow_inputs);
+    slow_next = 0;
+  }
+  return inputs;
+}
 
-  return rb_node_to_value(doc);
+static VALUE rb_set_metrics_enabled(VALUE self, VALUE rb_enabled) {
+  cmark_metrics_set_enabled(RTEST(rb_enabled));
+  return rb_enabled;
+}
+
+static VALUE rb_metrics_enabled(VALUE self) {
+  return cmark_metrics_enabled() ? Qtrue : Qfalse;
 }
 
 /*
@@ -328,6 +1097,12 @@ static VALUE rb_node_get_string_content(VALUE self) {
   Data_Get_Struct(self, cmark_node, node);
 
   text = cmark_node_get_literal(node);
+  /* Math nodes keep their TeX source verbatim in the node content. */
+  if (text == NULL && (node->type == CMARK_NODE_MATH_INLINE ||
+                       node->type == CMARK_NODE_MATH_DISPLAY ||
+                       node->type == CMARK_NODE_MATH_BLOCK)) {
+    text = cmark_node_get_string_content(node);
+  }
   if (text == NULL) {
     rb_raise(rb_eNodeError, "could not get string content");
   }
@@ -463,10 +1238,10 @@ static VALUE rb_node_get_sourcepos(VALUE self) {
   end_column = cmark_node_get_end_column(node);
 
   result = rb_hash_new();
-  rb_hash_aset(result, CSTR2SYM("start_line"), INT2NUM(start_line));
-  rb_hash_aset(result, CSTR2SYM("start_column"), INT2NUM(start_column));
-  rb_hash_aset(result, CSTR2SYM("end_line"), INT2NUM(end_line));
-  rb_hash_aset(result, CSTR2SYM("end_column"), INT2NUM(end_column));
+  rb_hash_aset(result, sym_start_line, INT2NUM(start_line));
+  rb_hash_aset(result, sym_start_column, INT2NUM(start_column));
+  rb_hash_aset(result, sym_end_line, INT2NUM(end_line));
+  rb_hash_aset(result, sym_end_column, INT2NUM(end_column));
 
   return result;
 }
@@ -547,51 +1322,391 @@ static VALUE rb_node_insert_before(VALUE self, VALUE sibling) {
   return Qtrue;
 }
 
+/*
+ * Internal: Fills 'attributes' from the frozen Array built by
+ * HtmlAttributes: one String or nil per slot, then the code language prefix.
+ */
+static void html_attributes_from_ary(VALUE rb_attributes,
+                                     cmark_html_attributes *attributes) {
+  VALUE value;
+  int i;
+
+  Check_Type(rb_attributes, T_ARRAY);
+  if (RARRAY_LEN(rb_attributes) != CMARK_HTML_ATTRIBUTES_COUNT + 1) {
+    rb_raise(rb_eArgError, "expected %d HTML attribute slots, got %ld",
+             CMARK_HTML_ATTRIBUTES_COUNT + 1, RARRAY_LEN(rb_attributes));
+  }
+
+  for (i = 0; i < CMARK_HTML_ATTRIBUTES_COUNT; ++i) {
+    value = rb_ary_entry(rb_attributes, i);
+    attributes->slots[i] = NIL_P(value) ? NULL : StringValueCStr(value);
+  }
+
+  value = rb_ary_entry(rb_attributes, CMARK_HTML_ATTRIBUTES_COUNT);
+  attributes->code_language_prefix = NIL_P(value) ? NULL : StringValueCStr(value);
+}
+
+/*
+ * Internal: Looks up the extensions named in 'rb_extensions' for rendering.
+ */
+static cmark_llist *render_extensions(VALUE rb_extensions, cmark_mem *mem) {
+  VALUE rb_ext_name;
+  long i;
+  cmark_llist *extensions = NULL;
+
+  Check_Type(rb_extensions, T_ARRAY);
+
+  for (i = 0; i < RARRAY_LEN(rb_extensions); ++i) {
+    rb_ext_name = RARRAY_PTR(rb_extensions)[i];
+
+    if (!SYMBOL_P(rb_ext_name)) {
+      cmark_llist_free(mem, extensions);
+      rb_raise(rb_eTypeError, "extension names should be Symbols; got a %"PRIsVALUE"", rb_obj_class(rb_ext_name));
+    }
+
+    cmark_syntax_extension *syntax_extension =
+      cmark_find_syntax_extension(rb_id2name(SYM2ID(rb_ext_name)));
+
+    if (!syntax_extension) {
+      cmark_llist_free(mem, extensions);
+      rb_raise(rb_eArgError, "extension %s not found\n", rb_id2name(SYM2ID(rb_ext_name)));
+    }
+
+    extensions = cmark_llist_append(mem, extensions, syntax_extension);
+  }
+
+  return extensions;
+}
+
 /* Internal: Convert the node to an HTML string.
  *
  * Returns a {String}.
  */
-static VALUE rb_render_html(VALUE self, VALUE rb_options, VALUE rb_extensions) {
-  int options, extensions_len;
-  VALUE rb_ext_name;
-  int i;
+static VALUE rb_render_html(int argc, VALUE *argv, VALUE self) {
+  VALUE rb_options, rb_extensions, rb_attributes, rb_deadline, ruby_html;
+  int options;
   cmark_node *node;
-  cmark_llist *extensions = NULL;
+  cmark_llist *extensions;
+  cmark_html_attributes attributes;
   cmark_mem *mem = cmark_get_default_mem_allocator();
+  int64_t deadline, started;
+
+  rb_scan_args(argc, argv, "22", &rb_options, &rb_extensions, &rb_attributes,
+               &rb_deadline);
+
   Check_Type(rb_options, T_FIXNUM);
   Check_Type(rb_extensions, T_ARRAY);
+  if (!NIL_P(rb_attributes))
+    html_attributes_from_ary(rb_attributes, &attributes);
 
   options = FIX2INT(rb_options);
-  extensions_len = RARRAY_LEN(rb_extensions);
+  deadline = deadline_from_value(rb_deadline);
 
   Data_Get_Struct(self, cmark_node, node);
 
-  for (i = 0; i < extensions_len; ++i) {
-    rb_ext_name = RARRAY_PTR(rb_extensions)[i];
+  extensions = render_extensions(rb_extensions, mem);
+
+  started = timing_start();
+  ruby_html = render_html_before(node, options, extensions,
+                                 NIL_P(rb_attributes) ? NULL : &attributes,
+                                 deadline);
+  if (!NIL_P(ruby_html))
+    timing_record(CMARK_METRICS_RENDER, started, extensions,
+                   metrics_input_bytes(self, RSTRING_LEN(ruby_html)));
+
+  cmark_llist_free(mem, extensions);
+
+  if (NIL_P(ruby_html)) {
+    rb_raise(rb_eTimeout, "rendering took too long");
+  }
+
+  return ruby_html;
+}
+
+#ifdef HAVE_ZLIB_H
+#define COMPRESS_CHUNK_SIZE (16 * 1024)
+
+// What compress_html returns once the deadline has passed.
+#define COMPRESS_TIMED_OUT 1
+
+/*
+ * The HTML is rendered with a stepper rather than cmark_render_html_stream,
+ * and deflated straight into the output String between steps. Growing the
+ * String may raise, so everything that needs freeing lives here, where
+ * free_compress_state can reach it from rb_ensure.
+ */
+struct compress_state {
+  z_stream stream;
+  int stream_ready;
+  VALUE out;
+  VALUE self;
+  VALUE rb_extensions;
+  cmark_node *node;
+  int options;
+  const cmark_html_attributes *attributes;
+  cmark_html_stepper *stepper;
+  cmark_llist *extensions;
+  int64_t deadline;
+};
+
+/*
+ * Runs the stream's pending input through deflate, appending to the output
+ * String and growing it by half as needed. Returns 0 on success.
+ */
+static int deflate_into(struct compress_state *state, int flush) {
+  z_stream *zs = &state->stream;
+  long len, avail;
+  int status;
+
+  for (;;) {
+    len = RSTRING_LEN(state->out);
+    if ((long)rb_str_capacity(state->out) - len < COMPRESS_CHUNK_SIZE / 4)
+      rb_str_modify_expand(state->out, len / 2 > COMPRESS_CHUNK_SIZE
+                                           ? len / 2
+                                           : COMPRESS_CHUNK_SIZE);
+
+    avail = (long)rb_str_capacity(state->out) - len;
+    zs->next_out = (Bytef *)RSTRING_PTR(state->out) + len;
+    zs->avail_out = avail > (long)UINT_MAX ? UINT_MAX : (uInt)avail;
+    status = deflate(zs, flush);
+    rb_str_set_len(state->out, (char *)zs->next_out - RSTRING_PTR(state->out));
+
+    if (status == Z_STREAM_ERROR)
+      return -1;
+    if (flush == Z_FINISH ? status == Z_STREAM_END : zs->avail_out != 0)
+      return 0;
+  }
+}
+
+static VALUE compress_html(VALUE data) {
+  struct compress_state *state = (struct compress_state *)data;
+  const char *chunk;
+  size_t len;
+  int status;
+  int64_t started = timing_start();
+
+  state->extensions = render_extensions(state->rb_extensions,
+                                        cmark_get_default_mem_allocator());
+  state->stepper = cmark_html_stepper_new(
+      state->node, state->options, state->extensions,
+      cmark_node_mem(state->node), state->attributes);
+
+  while ((chunk = cmark_html_stepper_next(state->stepper, SIZE_MAX,
+                                          COMPRESS_CHUNK_SIZE, &len))) {
+    state->stream.next_in = (Bytef *)chunk;
+    state->stream.avail_in = (uInt)len;
+    if ((status = deflate_into(state, Z_NO_FLUSH)))
+      return INT2FIX(status);
+    if (state->deadline && cmark_monotonic_ns() >= state->deadline)
+      return INT2FIX(COMPRESS_TIMED_OUT);
+  }
+
+  if ((status = deflate_into(state, Z_FINISH)))
+    return INT2FIX(status);
+  timing_record(CMARK_METRICS_RENDER, started, state->extensions,
+                metrics_input_bytes(state->self, state->stream.total_in));
+  return INT2FIX(0);
+}
+
+static VALUE free_compress_state(VALUE data) {
+  struct compress_state *state = (struct compress_state *)data;
+
+  if (state->stream_ready)
+    deflateEnd(&state->stream);
+  cmark_html_stepper_free(state->stepper);
+  cmark_llist_free(cmark_get_default_mem_allocator(), state->extensions);
+  return Qnil;
+}
+#endif
+
+/*
+ * Internal: Renders the node to HTML compressed with zlib, deflating the
+ * output as it is rendered instead of building the whole HTML first.
+ *
+ * format - :deflate for the zlib format, or :gzip
+ * level - The compression level, from 0 to 9, or -1 for the default
+ * deadline - An optional {Integer} time of the monotonic clock, in
+ *            nanoseconds, after which to give up and raise Timeout
+ */
+static VALUE rb_render_html_compressed(VALUE self, VALUE rb_options,
+                                       VALUE rb_extensions, VALUE rb_attributes,
+                                       VALUE rb_format, VALUE rb_level,
+                                       VALUE rb_deadline) {
+#ifdef HAVE_ZLIB_H
+  int level, window_bits, status;
+  cmark_html_attributes attributes;
+  struct compress_state state;
+
+  Check_Type(rb_options, T_FIXNUM);
+  Check_Type(rb_extensions, T_ARRAY);
+  Check_Type(rb_level, T_FIXNUM);
+
+  if (rb_format == sym_deflate) {
+    window_bits = MAX_WBITS;
+  } else if (rb_format == sym_gzip) {
+    window_bits = MAX_WBITS + 16;
+  } else {
+    rb_raise(rb_eArgError, "compression format must be :deflate or :gzip");
+  }
+
+  level = FIX2INT(rb_level);
+  if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+    rb_raise(rb_eArgError, "compression level must be between -1 and 9");
+  }
+
+  memset(&state, 0, sizeof(state));
+  if (!NIL_P(rb_attributes)) {
+    html_attributes_from_ary(rb_attributes, &attributes);
+    state.attributes = &attributes;
+  }
+
+  Data_Get_Struct(self, cmark_node, state.node);
+  state.self = self;
+  state.rb_extensions = rb_extensions;
+  state.options = FIX2INT(rb_options);
+  state.deadline = deadline_from_value(rb_deadline);
+  state.out = rb_str_buf_new(COMPRESS_CHUNK_SIZE);
+
+  if (deflateInit2(&state.stream, level, Z_DEFLATED, window_bits, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    rb_raise(rb_eNoMemError, "could not initialize zlib");
+  }
+  state.stream_ready = 1;
+
+  status = FIX2INT(rb_ensure(compress_html, (VALUE)&state,
+                             free_compress_state, (VALUE)&state));
+  RB_GC_GUARD(rb_attributes);
+
+  if (status == COMPRESS_TIMED_OUT) {
+    rb_raise(rb_eTimeout, "rendering took too long");
+  } else if (status) {
+    rb_raise(rb_eNodeError, "could not compress HTML");
+  }
+
+  /* Give back the room left from growing the String. */
+  return rb_str_resize(state.out, RSTRING_LEN(state.out));
+#else
+  rb_raise(rb_eNotImpError, "commonmarker was built without zlib");
+#endif
+}
+
+/*
+ * The state of a chunked render. It is wrapped in a Ruby object because an
+ * external enumeration (each_chunk.next) runs the render in a fiber, and
+ * when the Enumerator is dropped half way the fiber is collected without
+ * being unwound: rb_ensure never runs, and the garbage collector has to
+ * free the stepper instead. The object keeps the node, and the attribute
+ * strings the renderer points into, alive as long as the stepper.
+ */
+struct html_chunks {
+  cmark_html_stepper *stepper;
+  cmark_llist *extensions;
+  cmark_html_attributes attributes;
+  VALUE rb_node;
+  VALUE rb_attributes;
+  size_t max_nodes;
+  size_t max_bytes;
+};
+
+static void mark_html_chunks(void *data) {
+  struct html_chunks *chunks = (struct html_chunks *)data;
+
+  rb_gc_mark(chunks->rb_node);
+  rb_gc_mark(chunks->rb_attributes);
+}
+
+static void release_html_chunks(struct html_chunks *chunks) {
+  cmark_html_stepper_free(chunks->stepper);
+  chunks->stepper = NULL;
+  cmark_llist_free(cmark_get_default_mem_allocator(), chunks->extensions);
+  chunks->extensions = NULL;
+}
+
+static void dfree_html_chunks(void *data) {
+  release_html_chunks((struct html_chunks *)data);
+  xfree(data);
+}
+
+static const rb_data_type_t html_chunks_type = {
+    "commonmarker/html_chunks",
+    {mark_html_chunks, dfree_html_chunks, NULL},
+    NULL,
+    NULL,
+    RUBY_TYPED_FREE_IMMEDIATELY};
+
+static VALUE each_html_chunk(VALUE rb_chunks) {
+  struct html_chunks *chunks;
+  const char *chunk;
+  size_t len;
+
+  TypedData_Get_Struct(rb_chunks, struct html_chunks, &html_chunks_type,
+                       chunks);
+  while ((chunk = cmark_html_stepper_next(chunks->stepper, chunks->max_nodes,
+                                          chunks->max_bytes, &len))) {
+    if (len > 0)
+      rb_yield(rb_utf8_str_new(chunk, len));
+    else
+      rb_thread_check_ints();
+  }
+
+  return Qnil;
+}
+
+/* Frees the stepper as soon as the render is over, rather than at the next
+ * garbage collection. */
+static VALUE free_html_chunks(VALUE rb_chunks) {
+  struct html_chunks *chunks;
 
-    if (!SYMBOL_P(rb_ext_name)) {
-      cmark_llist_free(mem, extensions);
-      rb_raise(rb_eTypeError, "extension names should be Symbols; got a %"PRIsVALUE"", rb_obj_class(rb_ext_name));
-    }
+  TypedData_Get_Struct(rb_chunks, struct html_chunks, &html_chunks_type,
+                       chunks);
+  release_html_chunks(chunks);
+  return Qnil;
+}
 
-    cmark_syntax_extension *syntax_extension =
-      cmark_find_syntax_extension(rb_id2name(SYM2ID(rb_ext_name)));
+/*
+ * Internal: Renders the node to HTML a step at a time, yielding each piece
+ * of output. Each step renders at most 'max_nodes' iterator events, and
+ * stops early once 'max_bytes' of output are pending.
+ */
+static VALUE rb_each_html_chunk(VALUE self, VALUE rb_options,
+                                VALUE rb_extensions, VALUE rb_attributes,
+                                VALUE rb_max_nodes, VALUE rb_max_bytes) {
+  cmark_node *node;
+  struct html_chunks *chunks;
+  VALUE rb_chunks;
+  long max_nodes, max_bytes;
 
-    if (!syntax_extension) {
-      cmark_llist_free(mem, extensions);
-      rb_raise(rb_eArgError, "extension %s not found\n", rb_id2name(SYM2ID(rb_ext_name)));
-    }
+  rb_need_block();
+  Check_Type(rb_options, T_FIXNUM);
+  Check_Type(rb_extensions, T_ARRAY);
 
-    extensions = cmark_llist_append(mem, extensions, syntax_extension);
+  max_nodes = NUM2LONG(rb_max_nodes);
+  max_bytes = NUM2LONG(rb_max_bytes);
+  if (max_nodes <= 0 || max_bytes <= 0) {
+    rb_raise(rb_eArgError, "chunk limits must be positive");
   }
 
-  char *html = cmark_render_html(node, options, extensions);
-  VALUE ruby_html = rb_str_new2(html);
-
-  cmark_llist_free(mem, extensions);
-  free(html);
+  Data_Get_Struct(self, cmark_node, node);
 
-  return ruby_html;
+  rb_chunks = TypedData_Make_Struct(0, struct html_chunks, &html_chunks_type,
+                                    chunks);
+  chunks->rb_node = self;
+  chunks->rb_attributes = rb_attributes;
+  chunks->max_nodes = (size_t)max_nodes;
+  chunks->max_bytes = (size_t)max_bytes;
+  if (!NIL_P(rb_attributes))
+    html_attributes_from_ary(rb_attributes, &chunks->attributes);
+
+  chunks->extensions =
+      render_extensions(rb_extensions, cmark_get_default_mem_allocator());
+  chunks->stepper = cmark_html_stepper_new(
+      node, FIX2INT(rb_options), chunks->extensions, cmark_node_mem(node),
+      NIL_P(rb_attributes) ? NULL : &chunks->attributes);
+
+  rb_ensure(each_html_chunk, rb_chunks, free_html_chunks, rb_chunks);
+
+  RB_GC_GUARD(rb_chunks);
+  return self;
 }
 
 /* Internal: Convert the node to an XML string.
@@ -1136,12 +2251,66 @@ static VALUE rb_node_get_tasklist_state(VALUE self) {
   }
 }
 
-static VALUE rb_node_get_table_alignments(VALUE self) {
+/*
+ * Internal: Counts the task list items of a Markdown string, parsing only
+ * its block structure.
+ *
+ */
+static VALUE rb_markdown_to_tasklist_summary(VALUE self, VALUE rb_text,
+                                             VALUE rb_options) {
+  cmark_parser *parser;
+  cmark_node *doc, *cur;
+  cmark_iter *iter;
+  cmark_event_type ev_type;
+  long total = 0, checked = 0;
+  bool item_checked;
+  VALUE items, result;
+
+  Check_Type(rb_text, T_STRING);
+  Check_Type(rb_options, T_FIXNUM);
+
+  parser = cmark_parser_new(FIX2INT(rb_options) | CMARK_OPT_BLOCKS_ONLY);
+  cmark_parser_attach_syntax_extension(parser,
+                                       cmark_find_syntax_extension("tasklist"));
+
+  cmark_parser_feed(parser, RSTRING_PTR(rb_text), RSTRING_LEN(rb_text));
+  doc = cmark_parser_finish(parser);
+  cmark_parser_free(parser);
+
+  if (doc == NULL) {
+    rb_raise(rb_eNodeError, "error parsing document");
+  }
+
+  items = rb_ary_new();
+  iter = cmark_iter_new(doc);
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    cur = cmark_iter_get_node(iter);
+    if (ev_type != CMARK_EVENT_ENTER || cur->type != CMARK_NODE_ITEM ||
+        !cur->extension)
+      continue;
+
+    item_checked = cmark_gfm_extensions_get_tasklist_item_checked(cur);
+    total++;
+    if (item_checked)
+      checked++;
+    rb_ary_push(items, rb_assoc_new(INT2NUM(cur->start_line),
+                                    item_checked ? Qtrue : Qfalse));
+  }
+  cmark_iter_free(iter);
+  cmark_node_free(doc);
+
+  result = rb_hash_new();
+  rb_hash_aset(result, sym_total, LONG2NUM(total));
+  rb_hash_aset(result, sym_checked, LONG2NUM(checked));
+  rb_hash_aset(result, sym_items, items);
+
+  return result;
+}
+
+static VALUE table_alignments_to_ary(cmark_node *node) {
   uint16_t column_count, i;
   uint8_t *alignments;
-  cmark_node *node;
   VALUE ary;
-  Data_Get_Struct(self, cmark_node, node);
 
   column_count = cmark_gfm_extensions_get_table_columns(node);
   alignments = cmark_gfm_extensions_get_table_alignments(node);
@@ -1150,7 +2319,7 @@ static VALUE rb_node_get_table_alignments(VALUE self) {
     rb_raise(rb_eNodeError, "could not get column_count or alignments");
   }
 
-  ary = rb_ary_new();
+  ary = rb_ary_new2(column_count);
   for (i = 0; i < column_count; ++i) {
     if (alignments[i] == 'l')
       rb_ary_push(ary, sym_left);
@@ -1164,6 +2333,364 @@ static VALUE rb_node_get_table_alignments(VALUE self) {
   return ary;
 }
 
+static VALUE rb_node_get_table_alignments(VALUE self) {
+  cmark_node *node;
+  Data_Get_Struct(self, cmark_node, node);
+
+  return table_alignments_to_ary(node);
+}
+
+/* Append the text of a table cell's inlines to +buf+, dropping all markup.
+ * Raw HTML is dropped too, as to_plaintext does. */
+static void table_cell_plaintext(cmark_strbuf *buf, cmark_node *cell) {
+  cmark_event_type ev_type;
+  cmark_node *cur;
+  cmark_iter *iter = cmark_iter_new(cell);
+
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    if (ev_type != CMARK_EVENT_ENTER)
+      continue;
+
+    cur = cmark_iter_get_node(iter);
+    switch (cur->type) {
+    case CMARK_NODE_TEXT:
+    case CMARK_NODE_CODE:
+      cmark_strbuf_put(buf, cur->as.literal.data, cur->as.literal.len);
+      break;
+    case CMARK_NODE_SOFTBREAK:
+    case CMARK_NODE_LINEBREAK:
+      cmark_strbuf_putc(buf, ' ');
+      break;
+    default:
+      break;
+    }
+  }
+
+  cmark_iter_free(iter);
+}
+
+/* Append the inline HTML of a table cell's children to +buf+. */
+static void table_cell_html(cmark_strbuf *buf, cmark_node *cell, int options) {
+  cmark_node *child;
+  cmark_mem *mem = cmark_node_mem(cell);
+
+  for (child = cell->first_child; child; child = child->next) {
+    char *html = cmark_render_html_with_mem(child, options, NULL, mem);
+    cmark_strbuf_puts(buf, html);
+    mem->free(html);
+  }
+}
+
+static VALUE table_row_to_ary(cmark_strbuf *buf, cmark_node *row, int html,
+                              int options) {
+  cmark_node *cell;
+  VALUE ary = rb_ary_new();
+
+  for (cell = row->first_child; cell; cell = cell->next) {
+    cmark_strbuf_clear(buf);
+    if (html)
+      table_cell_html(buf, cell, options);
+    else
+      table_cell_plaintext(buf, cell);
+    rb_ary_push(ary, rb_utf8_str_new((const char *)buf->ptr, buf->size));
+  }
+
+  return ary;
+}
+
+struct table_collector {
+  cmark_node *root;
+  int html;
+  int options;
+  cmark_iter *iter;
+  cmark_strbuf buf;
+  /* Set when the tables come from a document parsed just for them. */
+  cmark_parser *parser;
+  cmark_node *doc;
+};
+
+/* Collect every table below the collector's root as a Hash of its
+ * alignments, header row and body rows. Cells are rendered to plaintext, or
+ * to inline HTML if +html+ is set, without wrapping any of the nodes in Ruby
+ * objects. */
+static VALUE collect_tables(VALUE data) {
+  struct table_collector *collector = (struct table_collector *)data;
+  cmark_event_type ev_type;
+  cmark_node *cur, *row;
+  VALUE tables = rb_ary_new();
+
+  collector->iter = cmark_iter_new(collector->root);
+
+  while ((ev_type = cmark_iter_next(collector->iter)) != CMARK_EVENT_DONE) {
+    cur = cmark_iter_get_node(collector->iter);
+    if (ev_type != CMARK_EVENT_ENTER || cur->type != CMARK_NODE_TABLE)
+      continue;
+
+    VALUE table = rb_hash_new();
+    VALUE header = Qnil;
+    VALUE rows = rb_ary_new();
+
+    for (row = cur->first_child; row; row = row->next) {
+      VALUE cells = table_row_to_ary(&collector->buf, row, collector->html,
+                                     collector->options);
+      if (NIL_P(header) && cmark_gfm_extensions_get_table_row_is_header(row))
+        header = cells;
+      else
+        rb_ary_push(rows, cells);
+    }
+
+    rb_hash_aset(table, sym_alignments, table_alignments_to_ary(cur));
+    rb_hash_aset(table, sym_table_header, header);
+    rb_hash_aset(table, sym_rows, rows);
+    rb_ary_push(tables, table);
+
+    /* Tables cannot nest, so there is nothing left to find inside. */
+    cmark_iter_reset(collector->iter, cur, CMARK_EVENT_EXIT);
+  }
+
+  return tables;
+}
+
+static VALUE free_table_collector(VALUE data) {
+  struct table_collector *collector = (struct table_collector *)data;
+
+  if (collector->iter)
+    cmark_iter_free(collector->iter);
+  cmark_strbuf_free(&collector->buf);
+  if (collector->parser)
+    cmark_parser_free(collector->parser);
+  if (collector->doc)
+    cmark_node_free(collector->doc);
+  return Qnil;
+}
+
+/* Runs collect_tables, freeing the collector even if Ruby raises while the
+ * result is built. */
+static VALUE collect_tables_ensure(struct table_collector *collector,
+                                   cmark_node *root, int html, int options) {
+  collector->root = root;
+  collector->html = html;
+  collector->options = options;
+  collector->iter = NULL;
+  cmark_strbuf_init(cmark_node_mem(root), &collector->buf, 0);
+
+  return rb_ensure(collect_tables, (VALUE)collector, free_table_collector,
+                   (VALUE)collector);
+}
+
+/* Internal: Extract all tables below the node.
+ *
+ * Returns an {Array} of {Hash}es.
+ */
+static VALUE rb_node_get_tables(VALUE self, VALUE rb_html, VALUE rb_options) {
+  cmark_node *node;
+  struct table_collector collector = {0};
+  Check_Type(rb_options, T_FIXNUM);
+
+  Data_Get_Struct(self, cmark_node, node);
+
+  return collect_tables_ensure(&collector, node, RTEST(rb_html),
+                               FIX2INT(rb_options));
+}
+
+/*
+ * Internal: Parses a Markdown string and extracts all of its tables.
+ *
+ */
+static VALUE rb_markdown_to_tables(VALUE self, VALUE rb_text, VALUE rb_options,
+                                   VALUE rb_extensions, VALUE rb_html) {
+  cmark_parser *parser;
+  cmark_node *doc;
+  struct table_collector collector = {0};
+
+  Check_Type(rb_text, T_STRING);
+
+  parser = prepare_parser(rb_options, rb_extensions);
+
+  cmark_parser_feed(parser, StringValuePtr(rb_text), RSTRING_LEN(rb_text));
+  doc = cmark_parser_finish(parser);
+
+  if (doc == NULL) {
+    cmark_parser_free(parser);
+    rb_raise(rb_eNodeError, "error parsing document");
+  }
+
+  collector.parser = parser;
+  collector.doc = doc;
+  return collect_tables_ensure(&collector, doc, RTEST(rb_html),
+                               parser->options);
+}
+
+static VALUE mention_reference(cmark_node *node) {
+  cmark_node *text = node->first_child;
+
+  if (!text || text->type != CMARK_NODE_TEXT)
+    return Qnil;
+
+  return rb_utf8_str_new((const char *)text->as.literal.data,
+                         text->as.literal.len);
+}
+
+/*
+ * Public: Resolves the mentions and issue references found by the
+ * `:mention` extension below the node, in one batch.
+ *
+ * The block is called once with an {Array} of all distinct references (such
+ * as `"@user"` or `"#123"`), and must return a {Hash} mapping references to
+ * URLs. Resolved references become links; the rest stay plain text.
+ *
+ * Returns the node.
+ */
+static VALUE rb_node_resolve_mentions(VALUE self) {
+  cmark_node *node, *cur;
+  cmark_iter *iter;
+  cmark_event_type ev_type;
+  VALUE refs, seen, resolved, ref, url;
+  long i;
+
+  rb_need_block();
+  Data_Get_Struct(self, cmark_node, node);
+
+  refs = rb_ary_new();
+  seen = rb_hash_new();
+  iter = cmark_iter_new(node);
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    cur = cmark_iter_get_node(iter);
+    if (ev_type != CMARK_EVENT_ENTER || cur->type != CMARK_NODE_MENTION)
+      continue;
+
+    ref = mention_reference(cur);
+    if (!NIL_P(ref) && NIL_P(rb_hash_lookup(seen, ref))) {
+      rb_hash_aset(seen, ref, Qtrue);
+      rb_ary_push(refs, ref);
+    }
+  }
+  cmark_iter_free(iter);
+
+  if (RARRAY_LEN(refs) == 0)
+    return self;
+
+  resolved = rb_yield(refs);
+  Check_Type(resolved, T_HASH);
+
+  /* Validate every URL up front so that nothing raises mid-walk. */
+  for (i = 0; i < RARRAY_LEN(refs); ++i) {
+    url = rb_hash_lookup(resolved, rb_ary_entry(refs, i));
+    if (!NIL_P(url)) {
+      StringValueCStr(url);
+      rb_hash_aset(seen, rb_ary_entry(refs, i), url);
+    } else {
+      rb_hash_delete(seen, rb_ary_entry(refs, i));
+    }
+  }
+
+  iter = cmark_iter_new(node);
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    cur = cmark_iter_get_node(iter);
+    if (ev_type != CMARK_EVENT_ENTER || cur->type != CMARK_NODE_MENTION)
+      continue;
+
+    ref = mention_reference(cur);
+    url = NIL_P(ref) ? Qnil : rb_hash_lookup(seen, ref);
+    if (!NIL_P(url))
+      cmark_gfm_extensions_resolve_mention(cur, RSTRING_PTR(url));
+  }
+  cmark_iter_free(iter);
+
+  return self;
+}
+
+/*
+ * Public: Returns the page a wikilink points to.
+ *
+ * Returns a {String}.
+ * Raises a NodeError if the node is not a wikilink.
+ */
+static VALUE rb_node_get_wikilink_target(VALUE self) {
+  const char *target;
+  cmark_node *node;
+  Data_Get_Struct(self, cmark_node, node);
+
+  target = cmark_gfm_extensions_get_wikilink_target(node);
+  if (target == NULL) {
+    rb_raise(rb_eNodeError, "node is not a wikilink");
+  }
+
+  return rb_utf8_str_new_cstr(target);
+}
+
+static VALUE rb_node_get_wikilink_missing(VALUE self) {
+  cmark_node *node;
+  Data_Get_Struct(self, cmark_node, node);
+
+  return cmark_gfm_extensions_get_wikilink_missing(node) ? Qtrue : Qfalse;
+}
+
+/*
+ * Public: Looks up the pages of the wikilinks found by the `:wikilink`
+ * extension below the node, in one batch.
+ *
+ * The block is called once with an {Array} of all distinct targets, and must
+ * return a collection (such as an {Array} or a {Set}) of those that exist.
+ * The others are rendered with the `wikilink-missing` class.
+ *
+ * Returns the node.
+ */
+static VALUE rb_node_resolve_wikilinks(VALUE self) {
+  cmark_node *node, *cur;
+  cmark_iter *iter;
+  cmark_event_type ev_type;
+  VALUE targets, seen, existing, target;
+  long i;
+
+  rb_need_block();
+  Data_Get_Struct(self, cmark_node, node);
+
+  targets = rb_ary_new();
+  seen = rb_hash_new();
+  iter = cmark_iter_new(node);
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    cur = cmark_iter_get_node(iter);
+    if (ev_type != CMARK_EVENT_ENTER || cur->type != CMARK_NODE_WIKILINK)
+      continue;
+
+    target = rb_utf8_str_new_cstr(cmark_gfm_extensions_get_wikilink_target(cur));
+    if (NIL_P(rb_hash_lookup(seen, target))) {
+      rb_hash_aset(seen, target, Qtrue);
+      rb_ary_push(targets, target);
+    }
+  }
+  cmark_iter_free(iter);
+
+  if (RARRAY_LEN(targets) == 0)
+    return self;
+
+  existing = rb_yield(targets);
+
+  /* Ask about every target up front so that nothing raises mid-walk. */
+  for (i = 0; i < RARRAY_LEN(targets); ++i) {
+    target = rb_ary_entry(targets, i);
+    rb_hash_aset(seen, target,
+                 RTEST(rb_funcall(existing, id_include_p, 1, target))
+                     ? Qtrue
+                     : Qfalse);
+  }
+
+  iter = cmark_iter_new(node);
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    cur = cmark_iter_get_node(iter);
+    if (ev_type != CMARK_EVENT_ENTER || cur->type != CMARK_NODE_WIKILINK)
+      continue;
+
+    target = rb_utf8_str_new_cstr(cmark_gfm_extensions_get_wikilink_target(cur));
+    cmark_gfm_extensions_set_wikilink_missing(
+        cur, !RTEST(rb_hash_lookup(seen, target)));
+  }
+  cmark_iter_free(iter);
+
+  return self;
+}
+
 /* Internal: Escapes href URLs safely. */
 static VALUE rb_html_escape_href(VALUE self, VALUE rb_text) {
   char *result;
@@ -1221,6 +2748,238 @@ VALUE rb_extensions(VALUE self) {
   return ary;
 }
 
+#ifdef HAVE_DLOPEN
+/* The init function of the plugin that load_extension is registering, and
+ * the name of an extension it tried to register twice. Only touched with
+ * the GVL held. */
+static cmark_plugin_init_func loading_plugin_init;
+static char loading_plugin_clash[128];
+
+/*
+ * Runs the plugin's init function, but refuses all of its extensions if
+ * one of them has the name of an extension already registered: it would
+ * never be found, or would shadow the registered one.
+ */
+static int register_loaded_plugin(cmark_plugin *plugin) {
+  cmark_llist *it, *other;
+  const char *name;
+  int clash;
+
+  if (!loading_plugin_init(plugin))
+    return 0;
+
+  for (it = plugin->syntax_extensions; it; it = it->next) {
+    name = ((cmark_syntax_extension *)it->data)->name;
+    clash = cmark_find_syntax_extension(name) != NULL;
+    for (other = plugin->syntax_extensions; other != it && !clash;
+         other = other->next)
+      clash = !strcmp(((cmark_syntax_extension *)other->data)->name, name);
+    if (clash) {
+      snprintf(loading_plugin_clash, sizeof(loading_plugin_clash), "%s", name);
+      return 0;
+    }
+  }
+
+  return 1;
+}
+#endif
+
+/*
+ * Internal: Loads the shared object at `rb_path` and registers the syntax
+ * extensions its `rb_init` function adds to the plugin it is given. The
+ * object stays loaded for the life of the process.
+ *
+ * Returns an {Array} of the names of the new extensions.
+ * Raises LoadError if the object or its init function can't be loaded or
+ * registers nothing, ArgumentError if an extension's name is taken, and
+ * NotImplementedError where dlopen is unavailable.
+ */
+static VALUE rb_load_extension(VALUE self, VALUE rb_path, VALUE rb_init) {
+#ifdef HAVE_DLOPEN
+  cmark_mem *mem = cmark_get_default_mem_allocator();
+  cmark_llist *exts, *it;
+  cmark_plugin_init_func init;
+  VALUE names = rb_ary_new(), error;
+  long registered = 0, i = 0;
+  void *handle;
+
+  FilePathValue(rb_path);
+  Check_Type(rb_init, T_STRING);
+
+  handle = dlopen(StringValueCStr(rb_path), RTLD_NOW | RTLD_LOCAL);
+  if (!handle)
+    rb_raise(rb_eLoadError, "%s", dlerror());
+
+  init = (cmark_plugin_init_func)dlsym(handle, StringValueCStr(rb_init));
+  if (!init) {
+    error = rb_str_new_cstr(dlerror());
+    dlclose(handle);
+    rb_raise(rb_eLoadError, "%" PRIsVALUE, error);
+  }
+
+  exts = cmark_list_syntax_extensions(mem);
+  for (it = exts; it; it = it->next)
+    registered++;
+  cmark_llist_free(mem, exts);
+
+  loading_plugin_init = init;
+  loading_plugin_clash[0] = '\0';
+  cmark_register_plugin(register_loaded_plugin);
+  loading_plugin_init = NULL;
+
+  exts = cmark_list_syntax_extensions(mem);
+  for (it = exts; it; it = it->next, i++) {
+    if (i >= registered)
+      rb_ary_push(names,
+                  rb_str_new2(((cmark_syntax_extension *)it->data)->name));
+  }
+  cmark_llist_free(mem, exts);
+
+  if (loading_plugin_clash[0]) {
+    dlclose(handle);
+    rb_raise(rb_eArgError, "extension %s is already registered",
+             loading_plugin_clash);
+  }
+  if (RARRAY_LEN(names) == 0) {
+    dlclose(handle);
+    rb_raise(rb_eLoadError, "%" PRIsVALUE " registered no extensions", rb_path);
+  }
+
+  return names;
+#else
+  rb_raise(rb_eNotImpError, "commonmarker was built without dlopen");
+#endif
+}
+
+static void rb_free_shared_cache(void *data) {
+  cmark_render_cache_free((cmark_render_cache *)data);
+}
+
+/*
+ * Public: Maps a render cache of `capacity` bytes into shared memory. Create
+ * it before forking: worker processes share the entries they store.
+ *
+ * Raises NotImplementedError where shared mappings are unavailable.
+ */
+static VALUE rb_shared_cache_new(VALUE klass, VALUE rb_capacity) {
+#ifdef HAVE_MMAP
+  cmark_render_cache *cache;
+  long capacity = NUM2LONG(rb_capacity);
+
+  if (capacity <= 0) {
+    rb_raise(rb_eArgError, "capacity must be positive");
+  }
+
+  cache = cmark_render_cache_new((size_t)capacity);
+  if (!cache) {
+    rb_sys_fail("mmap");
+  }
+
+  return Data_Wrap_Struct(klass, NULL, rb_free_shared_cache, cache);
+#else
+  rb_raise(rb_eNotImpError, "shared memory is not available on this platform");
+#endif
+}
+
+/*
+ * Internal: Builds the cache key for a document. The extension names are
+ * joined into 'names', which the caller frees.
+ */
+static void shared_cache_key(VALUE rb_text, VALUE rb_options,
+                             VALUE rb_extensions, cmark_strbuf *names,
+                             cmark_render_cache_key *key) {
+  VALUE name;
+  long i;
+
+  Check_Type(rb_text, T_STRING);
+  Check_Type(rb_options, T_FIXNUM);
+  Check_Type(rb_extensions, T_ARRAY);
+
+  for (i = 0; i < RARRAY_LEN(rb_extensions); ++i) {
+    name = rb_ary_entry(rb_extensions, i);
+    if (!SYMBOL_P(name)) {
+      cmark_strbuf_free(names);
+      rb_raise(rb_eTypeError, "extension names should be Symbols; got a %"PRIsVALUE"", rb_obj_class(name));
+    }
+    if (i > 0)
+      cmark_strbuf_putc(names, ',');
+    cmark_strbuf_puts(names, rb_id2name(SYM2ID(name)));
+  }
+
+  key->input = RSTRING_PTR(rb_text);
+  key->input_len = RSTRING_LEN(rb_text);
+  key->options = FIX2INT(rb_options);
+  key->extensions = (const char *)names->ptr;
+  key->extensions_len = names->size;
+}
+
+/*
+ * Public: Returns the HTML cached for the text, options and extensions, or
+ * yields to render it and stores what the block returns.
+ *
+ * text - A {String} of Markdown
+ * options - The {Integer} render options
+ * extensions - An {Array of Symbol}s naming the extensions
+ *
+ * Returns a {String}.
+ */
+static VALUE rb_shared_cache_fetch(VALUE self, VALUE rb_text, VALUE rb_options,
+                                   VALUE rb_extensions) {
+  cmark_render_cache *cache;
+  cmark_render_cache_key key;
+  cmark_mem *mem = cmark_get_default_mem_allocator();
+  cmark_strbuf names = CMARK_BUF_INIT(mem);
+  cmark_strbuf html = CMARK_BUF_INIT(mem);
+  VALUE rb_html;
+
+  rb_need_block();
+  Data_Get_Struct(self, cmark_render_cache, cache);
+
+  shared_cache_key(rb_text, rb_options, rb_extensions, &names, &key);
+
+  if (cmark_render_cache_get(cache, &key, &html)) {
+    rb_html = rb_utf8_str_new((const char *)html.ptr, html.size);
+    cmark_strbuf_free(&html);
+    cmark_strbuf_free(&names);
+    return rb_html;
+  }
+  cmark_strbuf_free(&names);
+
+  rb_html = rb_yield(Qnil);
+  Check_Type(rb_html, T_STRING);
+
+  /* The block may have run arbitrary code, so build the key again. */
+  shared_cache_key(rb_text, rb_options, rb_extensions, &names, &key);
+  cmark_render_cache_put(cache, &key, RSTRING_PTR(rb_html),
+                         RSTRING_LEN(rb_html));
+  cmark_strbuf_free(&names);
+
+  return rb_html;
+}
+
+/*
+ * Public: Returns the counters of the cache, shared by all processes.
+ *
+ * Returns a {Hash} of `:hits`, `:misses` and `:stores`, the `:capacity` in
+ * bytes and the total bytes `:written` so far.
+ */
+static VALUE rb_shared_cache_stats(VALUE self) {
+  cmark_render_cache *cache;
+  cmark_render_cache_stats stats;
+  VALUE result;
+
+  Data_Get_Struct(self, cmark_render_cache, cache);
+  cmark_render_cache_get_stats(cache, &stats);
+
+  result = rb_hash_new();
+  rb_hash_aset(result, CSTR2SYM("hits"), ULL2NUM(stats.hits));
+  rb_hash_aset(result, CSTR2SYM("misses"), ULL2NUM(stats.misses));
+  rb_hash_aset(result, CSTR2SYM("stores"), ULL2NUM(stats.stores));
+  rb_hash_aset(result, CSTR2SYM("capacity"), ULL2NUM(stats.capacity));
+  rb_hash_aset(result, CSTR2SYM("written"), ULL2NUM(stats.written));
+  return result;
+}
+
 __attribute__((visibility("default"))) void Init_commonmarker() {
   VALUE module;
   sym_document = ID2SYM(rb_intern("document"));
@@ -1247,21 +3006,74 @@ __attribute__((visibility("default"))) void Init_commonmarker() {
   sym_bullet_list = ID2SYM(rb_intern("bullet_list"));
   sym_ordered_list = ID2SYM(rb_intern("ordered_list"));
 
+  /* Not starting with '@' keeps it hidden from Ruby. */
+  id_source_bytes = rb_intern("source_bytes");
+
+  slow_inputs = rb_ary_new();
+  rb_gc_register_address(&slow_inputs);
+
   sym_left = ID2SYM(rb_intern("left"));
   sym_right = ID2SYM(rb_intern("right"));
   sym_center = ID2SYM(rb_intern("center"));
 
+  sym_start_line = ID2SYM(rb_intern("start_line"));
+  sym_start_column = ID2SYM(rb_intern("start_column"));
+  sym_end_line = ID2SYM(rb_intern("end_line"));
+  sym_end_column = ID2SYM(rb_intern("end_column"));
+  sym_deflate = ID2SYM(rb_intern("deflate"));
+  sym_gzip = ID2SYM(rb_intern("gzip"));
+  sym_total = ID2SYM(rb_intern("total"));
+  sym_checked = ID2SYM(rb_intern("checked"));
+  sym_items = ID2SYM(rb_intern("items"));
+  sym_alignments = ID2SYM(rb_intern("alignments"));
+  sym_table_header = ID2SYM(rb_intern("header"));
+  sym_rows = ID2SYM(rb_intern("rows"));
+  sym_input = ID2SYM(rb_intern("input"));
+  sym_input_bytes = ID2SYM(rb_intern("input_bytes"));
+  sym_truncated = ID2SYM(rb_intern("truncated"));
+  sym_digest = ID2SYM(rb_intern("digest"));
+  sym_options = ID2SYM(rb_intern("options"));
+  sym_extensions = ID2SYM(rb_intern("extensions"));
+  sym_parse_ns = ID2SYM(rb_intern("parse_ns"));
+  sym_render_ns = ID2SYM(rb_intern("render_ns"));
+  sym_timed_out = ID2SYM(rb_intern("timed_out"));
+  sym_at = ID2SYM(rb_intern("at"));
+  id_include_p = rb_intern("include?");
+
   module = rb_define_module("CommonMarker");
   rb_define_singleton_method(module, "extensions", rb_extensions, 0);
+  /* Whether the USDT probes in probes.h were compiled in. */
+  rb_define_const(module, "PROBES", CMARK_PROBES_ENABLED ? Qtrue : Qfalse);
+  rb_define_singleton_method(module, "metrics_enabled=", rb_set_metrics_enabled,
+                             1);
+  rb_define_singleton_method(module, "metrics_enabled?", rb_metrics_enabled, 0);
   rb_eNodeError = rb_define_class_under(module, "NodeError", rb_eStandardError);
+  rb_require("timeout");
+  rb_eTimeout = rb_define_class_under(module, "Timeout",
+                                      rb_path2class("Timeout::Error"));
+  rb_cSharedCache = rb_define_class_under(module, "SharedCache", rb_cObject);
+  rb_undef_alloc_func(rb_cSharedCache);
+  rb_define_singleton_method(rb_cSharedCache, "new", rb_shared_cache_new, 1);
+  rb_define_method(rb_cSharedCache, "fetch", rb_shared_cache_fetch, 3);
+  rb_define_method(rb_cSharedCache, "stats", rb_shared_cache_stats, 0);
   rb_cNode = rb_define_class_under(module, "Node", rb_cObject);
   rb_undef_alloc_func(rb_cNode);
   rb_define_singleton_method(rb_cNode, "markdown_to_html", rb_markdown_to_html,
-                             3);
+                             -1);
+  rb_define_singleton_method(rb_cNode, "memory_profile", rb_memory_profile, 3);
+  rb_define_singleton_method(rb_cNode, "metrics", rb_metrics, 1);
+  rb_define_singleton_method(rb_cNode, "capture_slow_inputs",
+                             rb_capture_slow_inputs, 3);
+  rb_define_singleton_method(rb_cNode, "slow_inputs", rb_slow_inputs, 1);
   rb_define_singleton_method(rb_cNode, "markdown_to_xml", rb_markdown_to_xml,
                              3);
+  rb_define_singleton_method(rb_cNode, "markdown_to_tables",
+                             rb_markdown_to_tables, 4);
+  rb_define_singleton_method(rb_cNode, "markdown_to_tasklist_summary",
+                             rb_markdown_to_tasklist_summary, 2);
   rb_define_singleton_method(rb_cNode, "new", rb_node_new, 1);
-  rb_define_singleton_method(rb_cNode, "parse_document", rb_parse_document, 4);
+  rb_define_singleton_method(rb_cNode, "parse_document", rb_parse_document, -1);
+  rb_define_singleton_method(rb_cNode, "load_extension", rb_load_extension, 2);
   rb_define_method(rb_cNode, "string_content", rb_node_get_string_content, 0);
   rb_define_method(rb_cNode, "string_content=", rb_node_set_string_content, 1);
   rb_define_method(rb_cNode, "type", rb_node_get_type, 0);
@@ -1271,7 +3083,9 @@ __attribute__((visibility("default"))) void Init_commonmarker() {
   rb_define_method(rb_cNode, "first_child", rb_node_first_child, 0);
   rb_define_method(rb_cNode, "next", rb_node_next, 0);
   rb_define_method(rb_cNode, "insert_before", rb_node_insert_before, 1);
-  rb_define_method(rb_cNode, "_render_html", rb_render_html, 2);
+  rb_define_method(rb_cNode, "_render_html", rb_render_html, -1);
+  rb_define_method(rb_cNode, "_render_html_compressed", rb_render_html_compressed, 6);
+  rb_define_method(rb_cNode, "_each_html_chunk", rb_each_html_chunk, 5);
   rb_define_method(rb_cNode, "_render_xml", rb_render_xml, 1);
   rb_define_method(rb_cNode, "_render_commonmark", rb_render_commonmark, -1);
   rb_define_method(rb_cNode, "_render_plaintext", rb_render_plaintext, -1);
@@ -1296,6 +3110,11 @@ __attribute__((visibility("default"))) void Init_commonmarker() {
   rb_define_method(rb_cNode, "fence_info", rb_node_get_fence_info, 0);
   rb_define_method(rb_cNode, "fence_info=", rb_node_set_fence_info, 1);
   rb_define_method(rb_cNode, "table_alignments", rb_node_get_table_alignments, 0);
+  rb_define_method(rb_cNode, "_tables", rb_node_get_tables, 2);
+  rb_define_method(rb_cNode, "resolve_mentions", rb_node_resolve_mentions, 0);
+  rb_define_method(rb_cNode, "resolve_wikilinks", rb_node_resolve_wikilinks, 0);
+  rb_define_method(rb_cNode, "wikilink_target", rb_node_get_wikilink_target, 0);
+  rb_define_method(rb_cNode, "wikilink_missing?", rb_node_get_wikilink_missing, 0);
   rb_define_method(rb_cNode, "tasklist_state", rb_node_get_tasklist_state, 0);
   rb_define_method(rb_cNode, "tasklist_item_checked?", rb_node_get_tasklist_item_checked, 0);
   rb_define_method(rb_cNode, "tasklist_item_checked=", rb_node_set_tasklist_item_checked, 1);
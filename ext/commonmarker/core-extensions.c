@@ -1,9 +1,13 @@
 #include "cmark-gfm-core-extensions.h"
 #include "autolink.h"
+#include "emoji.h"
+#include "mention.h"
 #include "strikethrough.h"
 #include "table.h"
 #include "tagfilter.h"
 #include "tasklist.h"
+#include "texmath.h"
+#include "wikilink.h"
 #include "registry.h"
 #include "plugin.h"
 
@@ -14,6 +18,10 @@ static int core_extensions_registration(cmark_plugin *plugin) {
   cmark_plugin_register_syntax_extension(plugin, create_autolink_extension());
   cmark_plugin_register_syntax_extension(plugin, create_tagfilter_extension());
   cmark_plugin_register_syntax_extension(plugin, create_tasklist_extension());
+  cmark_plugin_register_syntax_extension(plugin, create_mention_extension());
+  cmark_plugin_register_syntax_extension(plugin, create_emoji_extension());
+  cmark_plugin_register_syntax_extension(plugin, create_math_extension());
+  cmark_plugin_register_syntax_extension(plugin, create_wikilink_extension());
   return 1;
 }
 
@@ -0,0 +1,45 @@
+// For clock_gettime() under -std=c99.
+#define _POSIX_C_SOURCE 199309L
+
+#include "deadline.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+int64_t cmark_monotonic_ns(void) {
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER count;
+
+  if (!frequency.QuadPart)
+    QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&count);
+  return (int64_t)((double)count.QuadPart * 1e9 / (double)frequency.QuadPart);
+}
+
+int64_t cmark_realtime_ns(void) {
+  FILETIME now;
+  ULARGE_INTEGER ticks;
+
+  GetSystemTimeAsFileTime(&now);
+  ticks.LowPart = now.dwLowDateTime;
+  ticks.HighPart = now.dwHighDateTime;
+  /* 100ns ticks since 1601-01-01. */
+  return ((int64_t)ticks.QuadPart - 116444736000000000LL) * 100;
+}
+#else
+#include <time.h>
+
+int64_t cmark_monotonic_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+int64_t cmark_realtime_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+#endif
@@ -0,0 +1,26 @@
+#ifndef CMARK_DEADLINE_H
+#define CMARK_DEADLINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** Returns the time of the monotonic clock in nanoseconds: CLOCK_MONOTONIC,
+ * or the performance counter on Windows. Ruby's
+ * `Process.clock_gettime(Process::CLOCK_MONOTONIC, :nanosecond)` reads the
+ * same clock, so deadlines computed from it can be compared with this.
+ */
+int64_t cmark_monotonic_ns(void);
+
+/** Returns the wall-clock time in nanoseconds since the Unix epoch, for
+ * timestamps rather than deadlines.
+ */
+int64_t cmark_realtime_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
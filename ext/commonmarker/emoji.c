@@ -0,0 +1,87 @@
+#include "emoji.h"
+#include <parser.h>
+#include <string.h>
+
+#include "emoji.inc"
+
+// FNV-1a, seeded; must match emoji_hash in script/generate_emoji.
+static uint32_t emoji_hash(const uint8_t *name, size_t len, uint32_t seed) {
+  uint32_t hash = 0x811c9dc5 ^ seed;
+  size_t i;
+
+  for (i = 0; i < len; ++i) {
+    hash ^= name[i];
+    hash *= 0x01000193;
+  }
+
+  return hash;
+}
+
+static const char *lookup_emoji(const uint8_t *name, size_t len) {
+  uint16_t displacement =
+      emoji_displacements[emoji_hash(name, len, 0) % EMOJI_BUCKETS];
+  const struct emoji_slot *slot =
+      &emoji_slots[emoji_hash(name, len, displacement) % EMOJI_SLOTS];
+  const char *candidate = emoji_strings + slot->name;
+
+  if (!slot->name || strncmp(candidate, (const char *)name, len) != 0 ||
+      candidate[len] != '\0')
+    return NULL;
+
+  return emoji_strings + slot->value;
+}
+
+static bool is_name_char(uint8_t c) {
+  return cmark_isalnum(c) || c == '_' || c == '+' || c == '-';
+}
+
+static cmark_node *match(cmark_syntax_extension *self, cmark_parser *parser,
+                         cmark_node *parent, unsigned char c,
+                         cmark_inline_parser *inline_parser) {
+  cmark_chunk *chunk = cmark_inline_parser_get_chunk(inline_parser);
+  int offset = cmark_inline_parser_get_offset(inline_parser);
+  int start = cmark_inline_parser_get_column(inline_parser);
+  uint8_t *data = chunk->data + offset;
+  size_t size = chunk->len - offset;
+  size_t len;
+  const char *emoji;
+
+  if (c != ':')
+    return NULL;
+
+  for (len = 1; len < size && len <= EMOJI_MAX_NAME_LENGTH &&
+                is_name_char(data[len]);
+       ++len)
+    ;
+
+  if (len == 1 || len >= size || data[len] != ':')
+    return NULL;
+
+  emoji = lookup_emoji(data + 1, len - 1);
+  if (!emoji)
+    return NULL;
+
+  cmark_inline_parser_set_offset(inline_parser, offset + (int)len + 1);
+
+  cmark_node *node = cmark_node_new_with_mem(CMARK_NODE_TEXT, parser->mem);
+  cmark_node_set_literal(node, emoji);
+
+  node->start_line = node->end_line = cmark_inline_parser_get_line(inline_parser);
+  node->start_column = start - 1;
+  node->end_column = cmark_inline_parser_get_column(inline_parser) - 1;
+
+  return node;
+}
+
+cmark_syntax_extension *create_emoji_extension(void) {
+  cmark_syntax_extension *ext = cmark_syntax_extension_new("emoji");
+  cmark_llist *special_chars = NULL;
+
+  cmark_syntax_extension_set_match_inline_func(ext, match);
+
+  cmark_mem *mem = cmark_get_default_mem_allocator();
+  special_chars = cmark_llist_append(mem, special_chars, (void *)':');
+  cmark_syntax_extension_set_special_inline_chars(ext, special_chars);
+
+  return ext;
+}
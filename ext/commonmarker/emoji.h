@@ -0,0 +1,8 @@
+#ifndef CMARK_GFM_EMOJI_H
+#define CMARK_GFM_EMOJI_H
+
+#include "cmark-gfm-core-extensions.h"
+
+cmark_syntax_extension *create_emoji_extension(void);
+
+#endif
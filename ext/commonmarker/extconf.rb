@@ -3,5 +3,18 @@
 require 'mkmf'
 
 $CFLAGS << ' -std=c99'
+# Bind every symbol at load time, so that forked workers don't write lazily
+# resolved addresses into a page they share with their parent.
+append_ldflags('-Wl,-z,now')
+
+# Optional: Node#to_html(compress:) deflates the output as it is rendered.
+have_library('z', 'deflate') && have_header('zlib.h')
+# Optional: CommonMarker::SharedCache lives in a shared anonymous mapping.
+have_func('mmap', 'sys/mman.h')
+# Optional: CommonMarker.load_extension loads syntax extensions at run time.
+# dlopen moved from libdl into libc in glibc 2.34.
+have_func('dlopen', 'dlfcn.h') || (have_library('dl', 'dlopen') && have_func('dlopen', 'dlfcn.h'))
+# Optional: static tracepoints for bpftrace, perf and SystemTap.
+have_header('sys/sdt.h')
 
 create_makefile('commonmarker/commonmarker')
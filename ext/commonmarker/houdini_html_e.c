@@ -29,8 +29,9 @@ static const char HTML_ESCAPE_TABLE[] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 };
 
-static const char *HTML_ESCAPES[] = {"",      "&quot;", "&amp;", "&#39;",
-                                     "&#47;", "&lt;",   "&gt;"};
+static const char *const HTML_ESCAPES[] = {"",      "&quot;", "&amp;",
+                                           "&#39;", "&#47;",  "&lt;",
+                                           "&gt;"};
 
 int houdini_escape_html0(cmark_strbuf *ob, const uint8_t *src, bufsize_t size,
                          int secure) {
@@ -10,6 +10,8 @@
 #include "syntax_extension.h"
 #include "html.h"
 #include "render.h"
+#include "mem_stats.h"
+#include "probes.h"
 
 // Functions to convert cmark_nodes to HTML strings.
 
@@ -87,6 +89,54 @@ static bool S_put_footnote_backref(cmark_html_renderer *renderer, cmark_strbuf *
   return true;
 }
 
+// In compact mode, drops the line breaks a block node has just written
+// from 'start' on. Blocks with children only write tags themselves, so all
+// of theirs go; leaf blocks such as code keep the ones in their content.
+static void S_compact_block(cmark_strbuf *html, bufsize_t start,
+                            cmark_node *node) {
+  bufsize_t i, j;
+
+  if (!CMARK_NODE_BLOCK_P(node) || start == html->size)
+    return;
+
+  if (node->type == CMARK_NODE_HTML_BLOCK ||
+      node->type == CMARK_NODE_CUSTOM_BLOCK || !node->first_child) {
+    if (html->ptr[start] == '\n') {
+      memmove(html->ptr + start, html->ptr + start + 1, html->size - start - 1);
+      cmark_strbuf_truncate(html, html->size - 1);
+    }
+    if (node->type != CMARK_NODE_HTML_BLOCK &&
+        node->type != CMARK_NODE_CUSTOM_BLOCK && html->size - start >= 2 &&
+        html->ptr[html->size - 1] == '\n' && html->ptr[html->size - 2] == '>')
+      cmark_strbuf_truncate(html, html->size - 1);
+    return;
+  }
+
+  for (i = j = start; i < html->size; ++i) {
+    if (html->ptr[i] != '\n')
+      html->ptr[j++] = html->ptr[i];
+  }
+  cmark_strbuf_truncate(html, j);
+}
+
+// Whether a link leaves the site: "scheme://..." or "//...".
+static bool S_is_external_url(cmark_chunk *url) {
+  bufsize_t i = 0;
+
+  if (url->len > 0 && cmark_isalpha(url->data[0])) {
+    for (i = 1; i < url->len; ++i) {
+      if (!cmark_isalnum(url->data[i]) && url->data[i] != '+' &&
+          url->data[i] != '-' && url->data[i] != '.')
+        break;
+    }
+    if (i == url->len || url->data[i] != ':')
+      return false;
+    ++i;
+  }
+
+  return url->len - i >= 2 && url->data[i] == '/' && url->data[i + 1] == '/';
+}
+
 static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
                          cmark_event_type ev_type, int options) {
   cmark_node *parent;
@@ -139,6 +189,7 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
       cmark_html_render_cr(html);
       cmark_strbuf_puts(html, "<blockquote");
       cmark_html_render_sourcepos(node, html, options);
+      cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_BLOCK_QUOTE);
       cmark_strbuf_puts(html, ">\n");
     } else {
       cmark_html_render_cr(html);
@@ -155,15 +206,18 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
       if (list_type == CMARK_BULLET_LIST) {
         cmark_strbuf_puts(html, "<ul");
         cmark_html_render_sourcepos(node, html, options);
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_LIST);
         cmark_strbuf_puts(html, ">\n");
       } else if (start == 1) {
         cmark_strbuf_puts(html, "<ol");
         cmark_html_render_sourcepos(node, html, options);
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_LIST);
         cmark_strbuf_puts(html, ">\n");
       } else {
         snprintf(buffer, BUFFER_SIZE, "<ol start=\"%d\"", start);
         cmark_strbuf_puts(html, buffer);
         cmark_html_render_sourcepos(node, html, options);
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_LIST);
         cmark_strbuf_puts(html, ">\n");
       }
     } else {
@@ -190,6 +244,7 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
       start_heading[2] = (char)('0' + node->as.heading.level);
       cmark_strbuf_puts(html, start_heading);
       cmark_html_render_sourcepos(node, html, options);
+      cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_HEADING);
       cmark_strbuf_putc(html, '>');
     } else {
       end_heading[3] = (char)('0' + node->as.heading.level);
@@ -204,6 +259,7 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
     if (node->as.code.info.len == 0) {
       cmark_strbuf_puts(html, "<pre");
       cmark_html_render_sourcepos(node, html, options);
+      cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_CODE_BLOCK);
       cmark_strbuf_puts(html, "><code>");
     } else {
       bufsize_t first_tag = 0;
@@ -215,6 +271,7 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
       if (options & CMARK_OPT_GITHUB_PRE_LANG) {
         cmark_strbuf_puts(html, "<pre");
         cmark_html_render_sourcepos(node, html, options);
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_CODE_BLOCK);
         cmark_strbuf_puts(html, " lang=\"");
         escape_html(html, node->as.code.info.data, first_tag);
         if (first_tag < node->as.code.info.len && (options & CMARK_OPT_FULL_INFO_STRING)) {
@@ -225,7 +282,12 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
       } else {
         cmark_strbuf_puts(html, "<pre");
         cmark_html_render_sourcepos(node, html, options);
-        cmark_strbuf_puts(html, "><code class=\"language-");
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_CODE_BLOCK);
+        cmark_strbuf_puts(html, "><code class=\"");
+        cmark_strbuf_puts(html, renderer->attributes &&
+                                        renderer->attributes->code_language_prefix
+                                    ? renderer->attributes->code_language_prefix
+                                    : "language-");
         escape_html(html, node->as.code.info.data, first_tag);
         if (first_tag < node->as.code.info.len && (options & CMARK_OPT_FULL_INFO_STRING)) {
           cmark_strbuf_puts(html, "\" data-meta=\"");
@@ -283,6 +345,7 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
         cmark_html_render_cr(html);
         cmark_strbuf_puts(html, "<p");
         cmark_html_render_sourcepos(node, html, options);
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_PARAGRAPH);
         cmark_strbuf_putc(html, '>');
       } else {
         if (parent->type == CMARK_NODE_FOOTNOTE_DEFINITION && node->next == NULL) {
@@ -313,7 +376,9 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
     break;
 
   case CMARK_NODE_CODE:
-    cmark_strbuf_puts(html, "<code>");
+    cmark_strbuf_puts(html, "<code");
+    cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_CODE);
+    cmark_strbuf_putc(html, '>');
     escape_html(html, node->as.literal.data, node->as.literal.len);
     cmark_strbuf_puts(html, "</code>");
     break;
@@ -377,7 +442,11 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
         cmark_strbuf_puts(html, "\" title=\"");
         escape_html(html, node->as.link.title.data, node->as.link.title.len);
       }
-      cmark_strbuf_puts(html, "\">");
+      cmark_strbuf_putc(html, '"');
+      cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_LINK);
+      if (renderer->attributes && S_is_external_url(&node->as.link.url))
+        cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_EXTERNAL_LINK);
+      cmark_strbuf_putc(html, '>');
     } else {
       cmark_strbuf_puts(html, "</a>");
     }
@@ -399,7 +468,9 @@ static int S_render_node(cmark_html_renderer *renderer, cmark_node *node,
         escape_html(html, node->as.link.title.data, node->as.link.title.len);
       }
 
-      cmark_strbuf_puts(html, "\" />");
+      cmark_strbuf_putc(html, '"');
+      cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_IMAGE);
+      cmark_strbuf_puts(html, " />");
     }
     break;
 
@@ -454,33 +525,210 @@ char *cmark_render_html(cmark_node *root, int options, cmark_llist *extensions)
 }
 
 char *cmark_render_html_with_mem(cmark_node *root, int options, cmark_llist *extensions, cmark_mem *mem) {
-  char *result;
-  cmark_strbuf html = CMARK_BUF_INIT(mem);
-  cmark_event_type ev_type;
-  cmark_node *cur;
-  cmark_html_renderer renderer = {&html, NULL, NULL, 0, 0, NULL};
-  cmark_iter *iter = cmark_iter_new(root);
+  return cmark_render_html_with_attributes(root, options, extensions, mem, NULL);
+}
+
+static void S_init_renderer(cmark_html_renderer *renderer, cmark_strbuf *html,
+                            cmark_llist *extensions, cmark_mem *mem,
+                            const cmark_html_attributes *attributes) {
+  memset(renderer, 0, sizeof(*renderer));
+  renderer->html = html;
+  renderer->attributes = attributes;
 
   for (; extensions; extensions = extensions->next)
     if (((cmark_syntax_extension *) extensions->data)->html_filter_func)
-      renderer.filter_extensions = cmark_llist_append(
+      renderer->filter_extensions = cmark_llist_append(
           mem,
-          renderer.filter_extensions,
+          renderer->filter_extensions,
           (cmark_syntax_extension *) extensions->data);
+}
 
-  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
-    cur = cmark_iter_get_node(iter);
-    S_render_node(&renderer, cur, ev_type, options);
+static void S_render_event(cmark_html_renderer *renderer, cmark_iter *iter,
+                           cmark_event_type ev_type, int options) {
+  cmark_node *cur = cmark_iter_get_node(iter);
+  bufsize_t start = renderer->html->size;
+
+  S_render_node(renderer, cur, ev_type, options);
+  if (options & CMARK_OPT_COMPACT_HTML)
+    S_compact_block(renderer->html, start, cur);
+}
+
+static void S_finish_renderer(cmark_html_renderer *renderer, int options) {
+  if (renderer->footnote_ix) {
+    cmark_strbuf_puts(renderer->html, (options & CMARK_OPT_COMPACT_HTML)
+                                          ? "</ol></section>"
+                                          : "</ol>\n</section>\n");
   }
+}
+
+// How much of 'html' can be handed out while rendering is still under way:
+// the last byte stays behind for cmark_html_render_cr to look at, along with
+// any incomplete UTF-8 sequence before it.
+static bufsize_t S_flushable(cmark_strbuf *html) {
+  bufsize_t len = html->size - 1;
+
+  while (len > 0 && (html->ptr[len] & 0xC0) == 0x80)
+    len--;
+  return len;
+}
+
+// Renders 'root' into 'html'. With a 'flush' function, the output is handed
+// over whenever it grows past 'flush_size', and whatever is left at the end
+// is the caller's to flush. Returns 0, or the nonzero value 'flush' stopped
+// with.
+static int S_render_html(cmark_strbuf *html, cmark_node *root, int options,
+                         cmark_llist *extensions, cmark_mem *mem,
+                         const cmark_html_attributes *attributes,
+                         bufsize_t flush_size, cmark_html_flush_func flush,
+                         void *opaque) {
+  cmark_event_type ev_type;
+  bufsize_t len;
+  int status = 0;
+  size_t flushed = 0, nodes = 0;
+  cmark_html_renderer renderer;
+  cmark_iter *iter;
 
-  if (renderer.footnote_ix) {
-    cmark_strbuf_puts(&html, "</ol>\n</section>\n");
+  CMARK_PROBE2(render__start, "html", options);
+  cmark_mem_enter_phase(mem, CMARK_MEM_PHASE_RENDER);
+  iter = cmark_iter_new(root);
+  S_init_renderer(&renderer, html, extensions, mem, attributes);
+
+  while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
+    S_render_event(&renderer, iter, ev_type, options);
+    if (ev_type == CMARK_EVENT_ENTER)
+      nodes++;
+
+    if (flush && html->size > flush_size) {
+      len = S_flushable(html);
+      status = flush((const char *)html->ptr, (size_t)len, opaque);
+      if (status)
+        break;
+      cmark_strbuf_drop(html, len);
+      flushed += (size_t)len;
+    }
   }
 
-  result = (char *)cmark_strbuf_detach(&html);
+  if (!status)
+    S_finish_renderer(&renderer, options);
 
   cmark_llist_free(mem, renderer.filter_extensions);
 
   cmark_iter_free(iter);
-  return result;
+  CMARK_PROBE3(render__done, "html", flushed + (size_t)html->size, nodes);
+  return status;
+}
+
+char *cmark_render_html_with_attributes(cmark_node *root, int options,
+                                        cmark_llist *extensions, cmark_mem *mem,
+                                        const cmark_html_attributes *attributes) {
+  cmark_strbuf html = CMARK_BUF_INIT(mem);
+
+  S_render_html(&html, root, options, extensions, mem, attributes, 0, NULL,
+                NULL);
+
+  return (char *)cmark_strbuf_detach(&html);
+}
+
+int cmark_render_html_stream(cmark_node *root, int options,
+                             cmark_llist *extensions, cmark_mem *mem,
+                             const cmark_html_attributes *attributes,
+                             size_t chunk_size, cmark_html_flush_func flush,
+                             void *opaque) {
+  cmark_strbuf html = CMARK_BUF_INIT(mem);
+  int status;
+
+  if (chunk_size < 1)
+    chunk_size = 1;
+  if (chunk_size > INT32_MAX / 4)
+    chunk_size = INT32_MAX / 4;
+
+  status = S_render_html(&html, root, options, extensions, mem, attributes,
+                         (bufsize_t)chunk_size, flush, opaque);
+  if (!status && html.size)
+    status = flush((const char *)html.ptr, (size_t)html.size, opaque);
+
+  cmark_strbuf_free(&html);
+  return status;
+}
+
+struct cmark_html_stepper {
+  cmark_mem *mem;
+  int options;
+  cmark_strbuf html;
+  bufsize_t handed_out;
+  // Totals for the render__done probe.
+  size_t bytes;
+  size_t nodes;
+  cmark_html_renderer renderer;
+  cmark_iter *iter;
+  bool finished;
+};
+
+cmark_html_stepper *cmark_html_stepper_new(cmark_node *root, int options,
+                                           cmark_llist *extensions,
+                                           cmark_mem *mem,
+                                           const cmark_html_attributes *attributes) {
+  cmark_html_stepper *stepper;
+
+  cmark_mem_enter_phase(mem, CMARK_MEM_PHASE_RENDER);
+  stepper = (cmark_html_stepper *)mem->calloc(1, sizeof(cmark_html_stepper));
+
+  stepper->mem = mem;
+  stepper->options = options;
+  cmark_strbuf_init(mem, &stepper->html, 0);
+  S_init_renderer(&stepper->renderer, &stepper->html, extensions, mem,
+                  attributes);
+  stepper->iter = cmark_iter_new(root);
+  CMARK_PROBE2(render__start, "html", options);
+  return stepper;
+}
+
+const char *cmark_html_stepper_next(cmark_html_stepper *stepper,
+                                    size_t max_nodes, size_t max_bytes,
+                                    size_t *len) {
+  cmark_strbuf *html = &stepper->html;
+  cmark_event_type ev_type;
+  size_t nodes = 0;
+
+  cmark_strbuf_drop(html, stepper->handed_out);
+  stepper->bytes += (size_t)stepper->handed_out;
+  stepper->handed_out = 0;
+
+  // Always make some progress, whatever the limits.
+  while (!stepper->finished &&
+         (nodes == 0 || (nodes < max_nodes && (size_t)html->size < max_bytes))) {
+    ev_type = cmark_iter_next(stepper->iter);
+    if (ev_type == CMARK_EVENT_DONE) {
+      S_finish_renderer(&stepper->renderer, stepper->options);
+      stepper->finished = true;
+      CMARK_PROBE3(render__done, "html", stepper->bytes + (size_t)html->size,
+                   stepper->nodes);
+      break;
+    }
+    S_render_event(&stepper->renderer, stepper->iter, ev_type,
+                   stepper->options);
+    if (ev_type == CMARK_EVENT_ENTER)
+      stepper->nodes++;
+    nodes++;
+  }
+
+  if (stepper->finished) {
+    if (html->size == 0)
+      return NULL;
+    stepper->handed_out = html->size;
+  } else {
+    stepper->handed_out = html->size > 0 ? S_flushable(html) : 0;
+  }
+
+  *len = (size_t)stepper->handed_out;
+  return (const char *)html->ptr;
+}
+
+void cmark_html_stepper_free(cmark_html_stepper *stepper) {
+  if (!stepper)
+    return;
+  cmark_llist_free(stepper->mem, stepper->renderer.filter_extensions);
+  cmark_iter_free(stepper->iter);
+  cmark_strbuf_free(&stepper->html);
+  stepper->mem->free(stepper);
 }
@@ -3,6 +3,7 @@
 
 #include "buffer.h"
 #include "node.h"
+#include "render.h"
 
 CMARK_INLINE
 static void cmark_html_render_cr(cmark_strbuf *html) {
@@ -23,5 +24,11 @@ static void cmark_html_render_sourcepos(cmark_node *node, cmark_strbuf *html, in
   }
 }
 
+CMARK_INLINE
+static void cmark_html_render_attributes(cmark_html_renderer *renderer,
+                                         cmark_html_attributes_slot slot) {
+  if (renderer->attributes && renderer->attributes->slots[slot])
+    cmark_strbuf_puts(renderer->html, renderer->attributes->slots[slot]);
+}
 
 #endif
@@ -462,5 +462,5 @@ char *cmark_render_latex(cmark_node *root, int options, int width) {
 }
 
 char *cmark_render_latex_with_mem(cmark_node *root, int options, int width, cmark_mem *mem) {
-  return cmark_render(mem, root, options, width, outc, S_render_node);
+  return cmark_render("latex", mem, root, options, width, outc, S_render_node);
 }
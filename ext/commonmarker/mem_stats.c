@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem_stats.h"
+#include "node.h"
+
+// Each allocation is prefixed with its size, so that frees and reallocs
+// know how many bytes stop being live. Big enough to keep the alignment
+// that malloc guarantees.
+#define HEADER_SIZE 16
+
+static cmark_mem_stats stats;
+static cmark_mem_phase phase;
+
+static void S_live(int64_t delta) {
+  cmark_mem_phase_stats *current = &stats.phases[phase];
+
+  if (delta < 0 && (uint64_t)-delta > stats.live)
+    stats.live = 0;
+  else
+    stats.live += delta;
+
+  if (stats.live > stats.peak_live)
+    stats.peak_live = stats.live;
+  if (stats.live > current->peak_live)
+    current->peak_live = stats.live;
+}
+
+static void *S_oom(const char *what) {
+  fprintf(stderr, "[cmark] %s returned null pointer, aborting\n", what);
+  abort();
+  return NULL;
+}
+
+static void *counting_calloc(size_t nmem, size_t size) {
+  size_t bytes = nmem * size;
+  unsigned char *ptr = (unsigned char *)calloc(1, HEADER_SIZE + bytes);
+
+  if (!ptr)
+    return S_oom("calloc");
+
+  memcpy(ptr, &bytes, sizeof(bytes));
+  stats.phases[phase].allocs++;
+  stats.phases[phase].bytes += bytes;
+  S_live((int64_t)bytes);
+  return ptr + HEADER_SIZE;
+}
+
+static void *counting_realloc(void *ptr, size_t size) {
+  unsigned char *block;
+  size_t old_size;
+
+  if (!ptr)
+    return counting_calloc(1, size);
+
+  block = (unsigned char *)ptr - HEADER_SIZE;
+  memcpy(&old_size, block, sizeof(old_size));
+
+  block = (unsigned char *)realloc(block, HEADER_SIZE + size);
+  if (!block)
+    return S_oom("realloc");
+
+  memcpy(block, &size, sizeof(size));
+  stats.phases[phase].reallocs++;
+  if (size > old_size)
+    stats.phases[phase].bytes += size - old_size;
+  S_live((int64_t)size - (int64_t)old_size);
+  return block + HEADER_SIZE;
+}
+
+static void counting_free(void *ptr) {
+  unsigned char *block;
+  size_t size;
+
+  if (!ptr)
+    return;
+
+  block = (unsigned char *)ptr - HEADER_SIZE;
+  memcpy(&size, block, sizeof(size));
+  stats.phases[phase].frees++;
+  S_live(-(int64_t)size);
+  free(block);
+}
+
+static cmark_mem counting_mem = {counting_calloc, counting_realloc,
+                                 counting_free};
+
+cmark_mem *cmark_counting_mem_allocator(void) { return &counting_mem; }
+
+void cmark_counting_mem_reset(void) {
+  memset(&stats, 0, sizeof(stats));
+  phase = CMARK_MEM_PHASE_BLOCKS;
+}
+
+const cmark_mem_stats *cmark_counting_mem_stats(void) { return &stats; }
+
+size_t cmark_counting_mem_size(const void *ptr) {
+  size_t size;
+
+  memcpy(&size, (const unsigned char *)ptr - HEADER_SIZE, sizeof(size));
+  return size;
+}
+
+void cmark_mem_enter_phase(cmark_mem *mem, cmark_mem_phase new_phase) {
+  if (mem == &counting_mem)
+    phase = new_phase;
+}
+
+// 'alloc' only says whether the chunk owns its data, which then holds the
+// literal and a NUL.
+static size_t S_chunk_bytes(cmark_chunk *chunk) {
+  return chunk->alloc ? (size_t)chunk->len + 1 : 0;
+}
+
+size_t cmark_node_retained_bytes(cmark_node *node) {
+  size_t bytes = sizeof(cmark_node) + (size_t)node->content.asize;
+
+  switch (node->type) {
+  case CMARK_NODE_TEXT:
+  case CMARK_NODE_HTML_INLINE:
+  case CMARK_NODE_CODE:
+  case CMARK_NODE_HTML_BLOCK:
+  case CMARK_NODE_FOOTNOTE_REFERENCE:
+  case CMARK_NODE_FOOTNOTE_DEFINITION:
+    bytes += S_chunk_bytes(&node->as.literal);
+    break;
+  case CMARK_NODE_CODE_BLOCK:
+    bytes += S_chunk_bytes(&node->as.code.info);
+    bytes += S_chunk_bytes(&node->as.code.literal);
+    break;
+  case CMARK_NODE_LINK:
+  case CMARK_NODE_IMAGE:
+    bytes += S_chunk_bytes(&node->as.link.url);
+    bytes += S_chunk_bytes(&node->as.link.title);
+    break;
+  case CMARK_NODE_CUSTOM_BLOCK:
+  case CMARK_NODE_CUSTOM_INLINE:
+    bytes += S_chunk_bytes(&node->as.custom.on_enter);
+    bytes += S_chunk_bytes(&node->as.custom.on_exit);
+    break;
+  default:
+    break;
+  }
+
+  return bytes;
+}
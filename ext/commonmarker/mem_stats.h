@@ -0,0 +1,71 @@
+#ifndef CMARK_MEM_STATS_H
+#define CMARK_MEM_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cmark-gfm.h"
+
+/** The phases that allocations are attributed to. */
+typedef enum {
+  CMARK_MEM_PHASE_BLOCKS,
+  CMARK_MEM_PHASE_INLINES,
+  CMARK_MEM_PHASE_POSTPROCESS,
+  CMARK_MEM_PHASE_RENDER,
+  CMARK_MEM_PHASE_COUNT
+} cmark_mem_phase;
+
+typedef struct {
+  uint64_t allocs;
+  uint64_t reallocs;
+  uint64_t frees;
+  /* Bytes requested by allocations, plus what reallocations grew by. */
+  uint64_t bytes;
+  /* The most bytes live at once during the phase. */
+  uint64_t peak_live;
+} cmark_mem_phase_stats;
+
+typedef struct {
+  cmark_mem_phase_stats phases[CMARK_MEM_PHASE_COUNT];
+  uint64_t live;
+  uint64_t peak_live;
+} cmark_mem_stats;
+
+/** Returns an allocator that counts what goes through it, for passing to
+ * 'cmark_parser_new_with_mem' and the '_with_mem' renderers. It keeps one
+ * set of counters for the whole process and is not thread-safe: profile
+ * one document at a time.
+ */
+cmark_mem *cmark_counting_mem_allocator(void);
+
+/** Zeroes the counters and goes back to the block parsing phase. Memory
+ * still allocated from before is no longer counted as live.
+ */
+void cmark_counting_mem_reset(void);
+
+/** Returns the counters. */
+const cmark_mem_stats *cmark_counting_mem_stats(void);
+
+/** Returns the size that 'ptr', allocated by the counting allocator, was
+ * allocated or last reallocated with.
+ */
+size_t cmark_counting_mem_size(const void *ptr);
+
+/** Attributes what 'mem' allocates from now on to 'phase', if 'mem' is the
+ * counting allocator. The parser and renderers call this as they go.
+ */
+void cmark_mem_enter_phase(cmark_mem *mem, cmark_mem_phase phase);
+
+/** Returns the bytes that 'node' itself holds on to: the node, its content
+ * buffer, and the literals, URLs and titles it owns. Not its children.
+ */
+size_t cmark_node_retained_bytes(cmark_node *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
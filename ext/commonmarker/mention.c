@@ -0,0 +1,176 @@
+#include "mention.h"
+#include <parser.h>
+#include <render.h>
+#include <string.h>
+
+cmark_node_type CMARK_NODE_MENTION;
+
+// GitHub logins are at most 39 characters long.
+#define MAX_LOGIN_LENGTH 39
+#define MAX_ISSUE_DIGITS 10
+
+// A mention or reference must not be glued to the end of a word, an email
+// address, a path or another reference.
+static bool is_valid_preceding_char(uint8_t c) {
+  return !cmark_isalnum(c) && strchr("_-.+/@#&`", c) == NULL;
+}
+
+static size_t scan_login(const uint8_t *data, size_t size) {
+  size_t i;
+
+  if (size == 0 || !cmark_isalnum(data[0]))
+    return 0;
+
+  for (i = 1; i < size && i < MAX_LOGIN_LENGTH; ++i) {
+    if (!cmark_isalnum(data[i]) && data[i] != '-')
+      break;
+  }
+
+  while (data[i - 1] == '-')
+    --i;
+
+  return i;
+}
+
+static size_t scan_team(const uint8_t *data, size_t size) {
+  size_t i;
+
+  if (size < 2 || data[0] != '/' || !cmark_isalnum(data[1]))
+    return 0;
+
+  for (i = 2; i < size; ++i) {
+    if (!cmark_isalnum(data[i]) && data[i] != '-' && data[i] != '_')
+      break;
+  }
+
+  return i;
+}
+
+// Returns the length of `@login`, `@org/team` or `#123` at the start of
+// data, or 0 if there is none.
+static size_t scan_reference(const uint8_t *data, size_t size) {
+  size_t len;
+
+  if (data[0] == '@') {
+    len = scan_login(data + 1, size - 1);
+    if (len == 0)
+      return 0;
+    len += 1;
+    len += scan_team(data + len, size - len);
+  } else {
+    for (len = 1; len < size && cmark_isdigit(data[len]); ++len) {
+      if (len > MAX_ISSUE_DIGITS)
+        return 0;
+    }
+    if (len == 1)
+      return 0;
+  }
+
+  if (len < size && (cmark_isalnum(data[len]) || data[len] == '_' ||
+                     data[len] == '@' || data[len] == '#'))
+    return 0;
+
+  return len;
+}
+
+static cmark_node *match(cmark_syntax_extension *self, cmark_parser *parser,
+                         cmark_node *parent, unsigned char c,
+                         cmark_inline_parser *inline_parser) {
+  cmark_chunk *chunk = cmark_inline_parser_get_chunk(inline_parser);
+  int offset = cmark_inline_parser_get_offset(inline_parser);
+  int start = cmark_inline_parser_get_column(inline_parser);
+  uint8_t *data = chunk->data + offset;
+  size_t size = chunk->len - offset;
+  size_t len;
+
+  if (c != '@' && c != '#')
+    return NULL;
+
+  // Link text is left alone; code spans never reach us at all.
+  if (cmark_inline_parser_in_bracket(inline_parser, false) ||
+      cmark_inline_parser_in_bracket(inline_parser, true))
+    return NULL;
+
+  if (offset > 0 && !is_valid_preceding_char(data[-1]))
+    return NULL;
+
+  len = scan_reference(data, size);
+  if (len == 0)
+    return NULL;
+
+  cmark_inline_parser_set_offset(inline_parser, offset + (int)len);
+
+  cmark_node *node = cmark_node_new_with_mem(CMARK_NODE_MENTION, parser->mem);
+  cmark_node_set_syntax_extension(node, self);
+
+  cmark_node *text = cmark_node_new_with_mem(CMARK_NODE_TEXT, parser->mem);
+  text->as.literal = cmark_chunk_dup(chunk, offset, (bufsize_t)len);
+  cmark_node_append_child(node, text);
+
+  node->start_line = text->start_line =
+    node->end_line = text->end_line =
+    cmark_inline_parser_get_line(inline_parser);
+
+  node->start_column = text->start_column = start - 1;
+  node->end_column = text->end_column = cmark_inline_parser_get_column(inline_parser) - 1;
+
+  return node;
+}
+
+static const char *get_type_string(cmark_syntax_extension *extension,
+                                   cmark_node *node) {
+  return node->type == CMARK_NODE_MENTION ? "mention" : "<unknown>";
+}
+
+static int can_contain(cmark_syntax_extension *extension, cmark_node *node,
+                       cmark_node_type child_type) {
+  if (node->type != CMARK_NODE_MENTION)
+    return false;
+
+  return child_type == CMARK_NODE_TEXT;
+}
+
+// Unresolved mentions render as their plain text.
+static void render(cmark_syntax_extension *extension,
+                   cmark_renderer *renderer, cmark_node *node,
+                   cmark_event_type ev_type, int options) {
+}
+
+static void html_render(cmark_syntax_extension *extension,
+                        cmark_html_renderer *renderer, cmark_node *node,
+                        cmark_event_type ev_type, int options) {
+}
+
+cmark_syntax_extension *create_mention_extension(void) {
+  cmark_syntax_extension *ext = cmark_syntax_extension_new("mention");
+  cmark_llist *special_chars = NULL;
+
+  cmark_syntax_extension_set_get_type_string_func(ext, get_type_string);
+  cmark_syntax_extension_set_can_contain_func(ext, can_contain);
+  cmark_syntax_extension_set_commonmark_render_func(ext, render);
+  cmark_syntax_extension_set_plaintext_render_func(ext, render);
+  cmark_syntax_extension_set_latex_render_func(ext, render);
+  cmark_syntax_extension_set_man_render_func(ext, render);
+  cmark_syntax_extension_set_html_render_func(ext, html_render);
+  CMARK_NODE_MENTION = cmark_syntax_extension_add_node(1);
+
+  cmark_syntax_extension_set_match_inline_func(ext, match);
+
+  cmark_mem *mem = cmark_get_default_mem_allocator();
+  special_chars = cmark_llist_append(mem, special_chars, (void *)'@');
+  special_chars = cmark_llist_append(mem, special_chars, (void *)'#');
+  cmark_syntax_extension_set_special_inline_chars(ext, special_chars);
+
+  return ext;
+}
+
+int cmark_gfm_extensions_resolve_mention(cmark_node *node, const char *url) {
+  if (!node || node->type != CMARK_NODE_MENTION)
+    return 0;
+
+  if (!cmark_node_set_type(node, CMARK_NODE_LINK))
+    return 0;
+
+  node->extension = NULL;
+  return cmark_node_set_url(node, url);
+}
@@ -0,0 +1,9 @@
+#ifndef CMARK_GFM_MENTION_H
+#define CMARK_GFM_MENTION_H
+
+#include "cmark-gfm-core-extensions.h"
+
+extern cmark_node_type CMARK_NODE_MENTION;
+cmark_syntax_extension *create_mention_extension(void);
+
+#endif
@@ -0,0 +1,190 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "metrics.h"
+#include "syntax_extension.h"
+
+static int enabled;
+static uint64_t dropped;
+static cmark_metrics_series *series[CMARK_METRICS_MAX_SERIES];
+
+void cmark_metrics_set_enabled(int on) {
+  __atomic_store_n(&enabled, on != 0, __ATOMIC_RELAXED);
+}
+
+int cmark_metrics_enabled(void) {
+  return __atomic_load_n(&enabled, __ATOMIC_RELAXED);
+}
+
+static uint64_t S_name_hash(const char *name) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (; *name; name++)
+    hash = (hash ^ (unsigned char)*name) * 0x100000001b3ULL;
+  return hash;
+}
+
+// Identifies an extension set whatever the order of its extensions.
+static uint64_t S_key(cmark_llist *extensions) {
+  uint64_t key = 0x9e3779b97f4a7c15ULL;
+
+  for (; extensions; extensions = extensions->next)
+    key += S_name_hash(((cmark_syntax_extension *)extensions->data)->name);
+  return key ? key : 1;
+}
+
+static int S_compare_names(const void *a, const void *b) {
+  return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static char *S_names(cmark_llist *extensions) {
+  const char **names;
+  char *joined;
+  size_t count = 0, len = 1, i;
+  cmark_llist *it;
+
+  for (it = extensions; it; it = it->next, count++)
+    len += strlen(((cmark_syntax_extension *)it->data)->name) + 1;
+
+  names = (const char **)malloc((count ? count : 1) * sizeof(const char *));
+  joined = (char *)malloc(len);
+  if (!names || !joined) {
+    free(names);
+    free(joined);
+    return NULL;
+  }
+
+  for (it = extensions, i = 0; it; it = it->next, i++)
+    names[i] = ((cmark_syntax_extension *)it->data)->name;
+  qsort(names, count, sizeof(const char *), S_compare_names);
+
+  joined[0] = '\0';
+  for (i = 0; i < count; i++) {
+    if (i)
+      strcat(joined, ",");
+    strcat(joined, names[i]);
+  }
+
+  free(names);
+  return joined;
+}
+
+// Finds the series for 'extensions', claiming a free slot for it if it is
+// new. Returns NULL when every slot is taken by other sets.
+static cmark_metrics_series *S_series(cmark_llist *extensions) {
+  uint64_t key = S_key(extensions);
+  cmark_metrics_series *fresh = NULL, *found = NULL;
+  size_t i, slot;
+
+  for (i = 0; i < CMARK_METRICS_MAX_SERIES; i++) {
+    slot = (size_t)((key + i) % CMARK_METRICS_MAX_SERIES);
+    found = __atomic_load_n(&series[slot], __ATOMIC_ACQUIRE);
+
+    if (!found) {
+      if (!fresh) {
+        fresh = (cmark_metrics_series *)calloc(1, sizeof(cmark_metrics_series));
+        if (!fresh)
+          return NULL;
+        fresh->key = key;
+        fresh->extensions = S_names(extensions);
+      }
+      if (__atomic_compare_exchange_n(&series[slot], &found, fresh, 0,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return fresh;
+      // Another thread took the slot first; 'found' is its series.
+    }
+
+    if (found->key == key)
+      break;
+    found = NULL;
+  }
+
+  if (fresh) {
+    free(fresh->extensions);
+    free(fresh);
+  }
+  return found;
+}
+
+static int S_size_class(size_t bytes) {
+  int size_class = 0;
+
+  for (bytes >>= 8; bytes && size_class < CMARK_METRICS_SIZE_CLASSES - 1;
+       bytes >>= 2)
+    size_class++;
+  return size_class;
+}
+
+size_t cmark_metrics_size_class_min(int size_class) {
+  return size_class ? (size_t)256 << (2 * (size_class - 1)) : 0;
+}
+
+static int S_bucket(uint64_t ns) {
+  int exponent;
+
+  if (ns < 4)
+    return (int)ns;
+
+  exponent = 63 - __builtin_clzll(ns);
+  if (4 * (exponent - 1) >= CMARK_METRICS_BUCKETS)
+    return CMARK_METRICS_BUCKETS - 1;
+  return 4 * (exponent - 1) + (int)((ns >> (exponent - 2)) & 3);
+}
+
+uint64_t cmark_metrics_bucket_min(int bucket) {
+  if (bucket < 4)
+    return (uint64_t)bucket;
+  return (uint64_t)(4 + bucket % 4) << (bucket / 4 - 1);
+}
+
+void cmark_metrics_record(cmark_metrics_operation operation,
+                          cmark_llist *extensions, size_t input_bytes,
+                          int64_t ns) {
+  cmark_metrics_series *found = S_series(extensions);
+  cmark_metrics_histogram *histogram;
+  uint64_t value = ns > 0 ? (uint64_t)ns : 0;
+  uint64_t max;
+
+  if (!found) {
+    __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  histogram = &found->histograms[operation][S_size_class(input_bytes)];
+  __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&histogram->total_ns, value, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&histogram->buckets[S_bucket(value)], 1,
+                     __ATOMIC_RELAXED);
+
+  max = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+  while (value > max &&
+         !__atomic_compare_exchange_n(&histogram->max_ns, &max, value, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+cmark_metrics_series *cmark_metrics_series_at(size_t slot) {
+  if (slot >= CMARK_METRICS_MAX_SERIES)
+    return NULL;
+  return __atomic_load_n(&series[slot], __ATOMIC_ACQUIRE);
+}
+
+static uint64_t S_read(uint64_t *counter, int reset) {
+  return reset ? __atomic_exchange_n(counter, 0, __ATOMIC_RELAXED)
+               : __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+void cmark_metrics_read(cmark_metrics_histogram *histogram,
+                        cmark_metrics_histogram *out, int reset) {
+  int i;
+
+  out->count = S_read(&histogram->count, reset);
+  out->total_ns = S_read(&histogram->total_ns, reset);
+  out->max_ns = S_read(&histogram->max_ns, reset);
+  for (i = 0; i < CMARK_METRICS_BUCKETS; i++)
+    out->buckets[i] = S_read(&histogram->buckets[i], reset);
+}
+
+uint64_t cmark_metrics_dropped(int reset) {
+  return S_read(&dropped, reset);
+}
@@ -0,0 +1,90 @@
+#ifndef CMARK_METRICS_H
+#define CMARK_METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cmark-gfm.h"
+
+/** Latency histograms for parsing and rendering, kept for every extension
+ * set and input size class seen in the process. Recording only uses
+ * relaxed atomic increments, so it is safe and cheap from any thread.
+ */
+
+typedef enum {
+  CMARK_METRICS_PARSE,
+  CMARK_METRICS_RENDER,
+  CMARK_METRICS_OPERATIONS
+} cmark_metrics_operation;
+
+/* Inputs are classed by powers of four from 256 bytes: under 256 bytes,
+ * under 1 KiB, under 4 KiB, ... under 1 MiB, and 1 MiB or more. */
+#define CMARK_METRICS_SIZE_CLASSES 8
+
+/* Latencies are bucketed like an HDR histogram with two significant bits:
+ * four buckets per power of two of nanoseconds, up to 2^37 ns (about two
+ * minutes). The last bucket also takes anything longer. */
+#define CMARK_METRICS_BUCKETS 144
+
+/* How many distinct extension sets get their own histograms. Recordings
+ * for further sets are counted as dropped. */
+#define CMARK_METRICS_MAX_SERIES 64
+
+typedef struct {
+  uint64_t count;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  uint64_t buckets[CMARK_METRICS_BUCKETS];
+} cmark_metrics_histogram;
+
+typedef struct {
+  uint64_t key;
+  /* The extension names, sorted and separated by commas. */
+  char *extensions;
+  cmark_metrics_histogram
+      histograms[CMARK_METRICS_OPERATIONS][CMARK_METRICS_SIZE_CLASSES];
+} cmark_metrics_series;
+
+/** Turns recording on or off. It is off to begin with. */
+void cmark_metrics_set_enabled(int enabled);
+
+int cmark_metrics_enabled(void);
+
+/** Records that 'operation' took 'ns' nanoseconds on an input of
+ * 'input_bytes' with the syntax extensions in 'extensions'.
+ */
+void cmark_metrics_record(cmark_metrics_operation operation,
+                          cmark_llist *extensions, size_t input_bytes,
+                          int64_t ns);
+
+/** Returns the series in 'slot', from 0 to CMARK_METRICS_MAX_SERIES - 1,
+ * or NULL if no extension set has taken it yet. Series are never freed.
+ */
+cmark_metrics_series *cmark_metrics_series_at(size_t slot);
+
+/** Copies 'histogram' into 'out', zeroing each counter as it is read if
+ * 'reset' is set, so that nothing recorded meanwhile is lost. The copy is
+ * not a consistent snapshot of concurrent recordings.
+ */
+void cmark_metrics_read(cmark_metrics_histogram *histogram,
+                        cmark_metrics_histogram *out, int reset);
+
+/** Returns the number of recordings dropped for want of a free series,
+ * zeroing it if 'reset' is set.
+ */
+uint64_t cmark_metrics_dropped(int reset);
+
+/** The smallest input size in 'size_class', in bytes. */
+size_t cmark_metrics_size_class_min(int size_class);
+
+/** The smallest latency in 'bucket', in nanoseconds. */
+uint64_t cmark_metrics_bucket_min(int bucket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -162,7 +162,12 @@ static void S_free_nodes(cmark_node *e) {
       e->next = e->first_child;
     }
     next = e->next;
-    NODE_MEM(e)->free(e);
+    if (e->block) {
+      if (--e->block->live == 0)
+        e->block->mem->free(e->block);
+    } else {
+      NODE_MEM(e)->free(e);
+    }
     e = next;
   }
 }
@@ -173,6 +178,124 @@ void cmark_node_free(cmark_node *node) {
   S_free_nodes(node);
 }
 
+#define BLOCK_ALIGN(size)                                                      \
+  (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+// Points 'chunks' at the chunks that free_node_as would free, and returns
+// how many there are.
+static int S_node_chunks(cmark_node *node, cmark_chunk **chunks) {
+  switch (node->type) {
+  case CMARK_NODE_CODE_BLOCK:
+    chunks[0] = &node->as.code.info;
+    chunks[1] = &node->as.code.literal;
+    return 2;
+  case CMARK_NODE_TEXT:
+  case CMARK_NODE_HTML_INLINE:
+  case CMARK_NODE_CODE:
+  case CMARK_NODE_HTML_BLOCK:
+  case CMARK_NODE_FOOTNOTE_REFERENCE:
+  case CMARK_NODE_FOOTNOTE_DEFINITION:
+    chunks[0] = &node->as.literal;
+    return 1;
+  case CMARK_NODE_LINK:
+  case CMARK_NODE_IMAGE:
+    chunks[0] = &node->as.link.url;
+    chunks[1] = &node->as.link.title;
+    return 2;
+  case CMARK_NODE_CUSTOM_BLOCK:
+  case CMARK_NODE_CUSTOM_INLINE:
+    chunks[0] = &node->as.custom.on_enter;
+    chunks[1] = &node->as.custom.on_exit;
+    return 2;
+  default:
+    return 0;
+  }
+}
+
+// Returns the node after 'node' in depth-first order, without leaving the
+// tree under 'root'.
+static cmark_node *S_next_in_tree(cmark_node *node, cmark_node *root) {
+  if (node->first_child)
+    return node->first_child;
+  while (node != root && node->next == NULL)
+    node = node->parent;
+  return node == root ? NULL : node->next;
+}
+
+cmark_node *cmark_node_compact(cmark_node *root) {
+  cmark_mem *mem;
+  cmark_node_block *block;
+  cmark_chunk *chunks[2];
+  cmark_node *cur, *copy;
+  unsigned char *start, *end, *p;
+  size_t size = BLOCK_ALIGN(sizeof(cmark_node_block));
+  int i, n;
+
+  if (root == NULL || root->parent != NULL)
+    return NULL;
+
+  for (cur = root; cur; cur = S_next_in_tree(cur, root)) {
+    size += BLOCK_ALIGN(sizeof(cmark_node));
+    n = S_node_chunks(cur, chunks);
+    for (i = 0; i < n; i++)
+      size += BLOCK_ALIGN((size_t)chunks[i]->len + 1);
+  }
+
+  mem = NODE_MEM(root);
+  start = (unsigned char *)mem->calloc(1, size);
+  end = start + size;
+  block = (cmark_node_block *)start;
+  block->mem = mem;
+  p = start + BLOCK_ALIGN(sizeof(cmark_node_block));
+
+  // Copy each node and its literals, taking over everything it owns apart
+  // from the literals, and leave a pointer to the copy in its user data.
+  for (cur = root; cur; cur = S_next_in_tree(cur, root)) {
+    copy = (cmark_node *)p;
+    *copy = *cur;
+    copy->block = block;
+    block->live++;
+    p += BLOCK_ALIGN(sizeof(cmark_node));
+
+    n = S_node_chunks(copy, chunks);
+    for (i = 0; i < n; i++) {
+      if (chunks[i]->len > 0)
+        memcpy(p, chunks[i]->data, (size_t)chunks[i]->len);
+      p[chunks[i]->len] = '\0';
+      chunks[i]->data = p;
+      chunks[i]->alloc = 0;
+      p += BLOCK_ALIGN((size_t)chunks[i]->len + 1);
+    }
+
+    cmark_strbuf_init(mem, &cur->content, 0);
+    cur->user_data = copy;
+    cur->user_data_free_func = NULL;
+    cur->extension = NULL;
+  }
+
+#define COPY_OF(node) ((cmark_node *)(node)->user_data)
+  for (cur = root; cur; cur = S_next_in_tree(cur, root)) {
+    copy = COPY_OF(cur);
+    if (cur != root) {
+      copy->parent = COPY_OF(cur->parent);
+      copy->prev = cur->prev ? COPY_OF(cur->prev) : NULL;
+      copy->next = cur->next ? COPY_OF(cur->next) : NULL;
+    }
+    copy->first_child = cur->first_child ? COPY_OF(cur->first_child) : NULL;
+    copy->last_child = cur->last_child ? COPY_OF(cur->last_child) : NULL;
+    // A footnote definition outside the tree keeps its place.
+    if (cur->parent_footnote_def &&
+        (unsigned char *)cur->parent_footnote_def->user_data >= start &&
+        (unsigned char *)cur->parent_footnote_def->user_data < end)
+      copy->parent_footnote_def = COPY_OF(cur->parent_footnote_def);
+  }
+  copy = COPY_OF(root);
+#undef COPY_OF
+
+  S_free_nodes(root);
+  return copy;
+}
+
 cmark_node_type cmark_node_get_type(cmark_node *node) {
   if (node == NULL) {
     return CMARK_NODE_NONE;
@@ -48,6 +48,13 @@ typedef struct {
   cmark_chunk on_exit;
 } cmark_custom;
 
+/* The contiguous block that 'cmark_node_compact' copies a tree into. It
+ * is freed once the last node in it is. */
+typedef struct cmark_node_block {
+  cmark_mem *mem;
+  size_t live;
+} cmark_node_block;
+
 enum cmark_node__internal_flags {
   CMARK_NODE__OPEN = (1 << 0),
   CMARK_NODE__LAST_LINE_BLANK = (1 << 1),
@@ -83,6 +90,10 @@ struct cmark_node {
 
   cmark_node *parent_footnote_def;
 
+  /* The block this node was compacted into, or NULL if it was allocated
+   * on its own. */
+  cmark_node_block *block;
+
   union {
     cmark_chunk literal;
     cmark_list list;
@@ -49,8 +49,21 @@ struct cmark_parser {
   cmark_llist *syntax_extensions;
   cmark_llist *inline_syntax_extensions;
   cmark_ispunct_func backslash_ispunct;
+  /* The characters that stop a run of text in the inline parser, and those
+   * that emphasis flanking looks past; the core set plus the extensions'.
+   * Kept per parser so that parsers can run concurrently. */
+  int8_t special_chars[256];
+  int8_t skip_chars[256];
+  /* See the documentation for cmark_parser_set_deadline() in cmark.h */
+  int64_t deadline;
+  unsigned int deadline_ticks;
+  bool timed_out;
 };
 
+/* Returns true once the parser's deadline has passed, reading the clock
+ * only every so many calls. */
+bool cmark_parser_check_deadline(cmark_parser *parser);
+
 #ifdef __cplusplus
 }
 #endif
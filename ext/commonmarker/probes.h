@@ -0,0 +1,42 @@
+#ifndef CMARK_PROBES_H
+#define CMARK_PROBES_H
+
+/* Static tracepoints (USDT) under the provider "commonmarker", for attaching
+ * bpftrace, perf or SystemTap to a running process:
+ *
+ *   bpftrace -e 'usdt:/path/to/commonmarker.so:commonmarker:render__done
+ *                { @bytes[str(arg0)] = hist(arg1); }'
+ *
+ * They are compiled in when <sys/sdt.h> is available. A probe that nothing
+ * is attached to is a single nop; without <sys/sdt.h> they compile to
+ * nothing at all.
+ *
+ *   parse__feed__start(bytes)
+ *   parse__feed__done(bytes, lines)           lines: lines parsed so far
+ *   parse__finish__start(lines)
+ *   parse__finish__done(lines, timed_out)
+ *   inlines__start()
+ *   inlines__done(nodes)                      nodes: block and inline nodes
+ *   postprocess__start(extension)             extension: its name
+ *   postprocess__done(extension)
+ *   render__start(format, options)            format: "html", "xml", ...
+ *   render__done(format, bytes, nodes)
+ */
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+
+#define CMARK_PROBES_ENABLED 1
+#define CMARK_PROBE0(name) DTRACE_PROBE(commonmarker, name)
+#define CMARK_PROBE1(name, a) DTRACE_PROBE1(commonmarker, name, a)
+#define CMARK_PROBE2(name, a, b) DTRACE_PROBE2(commonmarker, name, a, b)
+#define CMARK_PROBE3(name, a, b, c) DTRACE_PROBE3(commonmarker, name, a, b, c)
+#else
+#define CMARK_PROBES_ENABLED 0
+#define CMARK_PROBE0(name) ((void)0)
+#define CMARK_PROBE1(name, a) ((void)(a))
+#define CMARK_PROBE2(name, a, b) ((void)(a), (void)(b))
+#define CMARK_PROBE3(name, a, b, c) ((void)(a), (void)(b), (void)(c))
+#endif
+
+#endif
@@ -6,6 +6,8 @@
 #include "render.h"
 #include "node.h"
 #include "syntax_extension.h"
+#include "mem_stats.h"
+#include "probes.h"
 
 static CMARK_INLINE void S_cr(cmark_renderer *renderer) {
   if (renderer->need_cr < 1) {
@@ -161,7 +163,8 @@ void cmark_render_code_point(cmark_renderer *renderer, uint32_t c) {
   renderer->column += 1;
 }
 
-char *cmark_render(cmark_mem *mem, cmark_node *root, int options, int width,
+char *cmark_render(const char *format, cmark_mem *mem, cmark_node *root,
+                   int options, int width,
                    void (*outc)(cmark_renderer *, cmark_node *,
                                 cmark_escaping, int32_t,
                                 unsigned char),
@@ -173,7 +176,12 @@ char *cmark_render(cmark_mem *mem, cmark_node *root, int options, int width,
   cmark_node *cur;
   cmark_event_type ev_type;
   char *result;
-  cmark_iter *iter = cmark_iter_new(root);
+  cmark_iter *iter;
+  size_t nodes = 0;
+
+  CMARK_PROBE2(render__start, format, options);
+  cmark_mem_enter_phase(mem, CMARK_MEM_PHASE_RENDER);
+  iter = cmark_iter_new(root);
 
   cmark_renderer renderer = {mem,   &buf, &pref, 0,           width,
                              0,     0,    true,  true,        false,
@@ -182,6 +190,8 @@ char *cmark_render(cmark_mem *mem, cmark_node *root, int options, int width,
 
   while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
     cur = cmark_iter_get_node(iter);
+    if (ev_type == CMARK_EVENT_ENTER)
+      nodes++;
     if (!render_node(&renderer, cur, ev_type, options)) {
       // a false value causes us to skip processing
       // the node's contents.  this is used for
@@ -195,6 +205,7 @@ char *cmark_render(cmark_mem *mem, cmark_node *root, int options, int width,
     cmark_strbuf_putc(renderer.buffer, '\n');
   }
 
+  CMARK_PROBE3(render__done, format, (size_t)renderer.buffer->size, nodes);
   result = (char *)cmark_strbuf_detach(renderer.buffer);
 
   cmark_iter_free(iter);
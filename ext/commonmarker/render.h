@@ -39,6 +39,7 @@ struct cmark_html_renderer {
   unsigned int footnote_ix;
   unsigned int written_footnote_ix;
   void *opaque;
+  const cmark_html_attributes *attributes;
 };
 
 typedef struct cmark_html_renderer cmark_html_renderer;
@@ -47,7 +48,8 @@ void cmark_render_ascii(cmark_renderer *renderer, const char *s);
 
 void cmark_render_code_point(cmark_renderer *renderer, uint32_t c);
 
-char *cmark_render(cmark_mem *mem, cmark_node *root, int options, int width,
+char *cmark_render(const char *format, cmark_mem *mem, cmark_node *root,
+                   int options, int width,
                    void (*outc)(cmark_renderer *, cmark_node *,
                                 cmark_escaping, int32_t,
                                 unsigned char),
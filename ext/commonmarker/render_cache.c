@@ -0,0 +1,259 @@
+// For MAP_ANONYMOUS and kill() under -std=c99.
+#define _DEFAULT_SOURCE
+
+#include "render_cache.h"
+
+#ifdef HAVE_MMAP
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC UINT64_C(0x636d61726b636163) /* "cmarkcac" */
+#define ALIGNMENT 8
+#define ALIGN(n) (((n) + ALIGNMENT - 1) & ~(uint64_t)(ALIGNMENT - 1))
+
+// Roughly one index bucket per this many bytes of entries.
+#define BYTES_PER_BUCKET 2048
+// No single entry may take more than this share of the ring.
+#define MAX_ENTRY_SHARE 8
+
+typedef struct {
+  uint64_t magic;
+  uint64_t capacity;  /* size of the ring, in bytes */
+  uint64_t n_buckets;
+  uint64_t write_end; /* logical end of the ring; only grows */
+  int32_t lock;       /* pid of the writer, or 0 */
+  uint32_t padding;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t stores;
+} cache_header;
+
+// Followed by the input, the extensions and the value.
+typedef struct {
+  uint64_t hash;
+  int32_t options;
+  uint32_t input_len;
+  uint32_t extensions_len;
+  uint32_t value_len;
+} cache_entry;
+
+struct cmark_render_cache {
+  cache_header *header;
+  uint64_t *buckets; /* logical offset of an entry plus one, or 0 */
+  unsigned char *ring;
+  size_t mapped;
+};
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+  size_t i;
+
+  for (i = 0; i < len; ++i) {
+    hash ^= p[i];
+    hash *= UINT64_C(0x100000001b3);
+  }
+  return hash;
+}
+
+static uint64_t key_hash(const cmark_render_cache_key *key) {
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+
+  hash = hash_bytes(hash, &key->options, sizeof(key->options));
+  hash = hash_bytes(hash, key->extensions, key->extensions_len);
+  hash = hash_bytes(hash, "\0", 1);
+  return hash_bytes(hash, key->input, key->input_len);
+}
+
+static uint64_t entry_size(uint64_t input_len, uint64_t extensions_len,
+                           uint64_t value_len) {
+  return ALIGN(sizeof(cache_entry) + input_len + extensions_len + value_len);
+}
+
+cmark_render_cache *cmark_render_cache_new(size_t capacity) {
+  cmark_render_cache *cache;
+  uint64_t n_buckets;
+  size_t index_size, mapped;
+  void *base;
+
+  capacity = (size_t)ALIGN(capacity);
+  if (capacity < 64 * 1024)
+    capacity = 64 * 1024;
+
+  n_buckets = capacity / BYTES_PER_BUCKET;
+  index_size = (size_t)ALIGN(n_buckets * sizeof(uint64_t));
+  mapped = sizeof(cache_header) + index_size + capacity;
+
+  base = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+              -1, 0);
+  if (base == MAP_FAILED)
+    return NULL;
+
+  cache = (cmark_render_cache *)calloc(1, sizeof(*cache));
+  if (!cache) {
+    munmap(base, mapped);
+    return NULL;
+  }
+
+  // The mapping starts out zeroed: no entries, and the lock is free.
+  cache->header = (cache_header *)base;
+  cache->buckets = (uint64_t *)((unsigned char *)base + sizeof(cache_header));
+  cache->ring = (unsigned char *)cache->buckets + index_size;
+  cache->mapped = mapped;
+  cache->header->magic = CACHE_MAGIC;
+  cache->header->capacity = capacity;
+  cache->header->n_buckets = n_buckets;
+
+  return cache;
+}
+
+void cmark_render_cache_free(cmark_render_cache *cache) {
+  if (!cache)
+    return;
+
+  munmap(cache->header, cache->mapped);
+  free(cache);
+}
+
+// An entry at 'pos' is intact as long as no writer has claimed the space
+// one lap of the ring after it.
+static int entry_live(cache_header *header, uint64_t pos, uint64_t size) {
+  uint64_t end = __atomic_load_n(&header->write_end, __ATOMIC_ACQUIRE);
+
+  return end <= pos + header->capacity && pos + size <= end;
+}
+
+int cmark_render_cache_get(cmark_render_cache *cache,
+                           const cmark_render_cache_key *key,
+                           cmark_strbuf *out) {
+  cache_header *header = cache->header;
+  uint64_t hash = key_hash(key);
+  uint64_t pos, size, offset;
+  bufsize_t start = out->size;
+  const unsigned char *data;
+  cache_entry entry;
+
+  pos = __atomic_load_n(&cache->buckets[hash % header->n_buckets],
+                        __ATOMIC_ACQUIRE);
+  if (pos-- == 0)
+    goto miss;
+
+  offset = pos % header->capacity;
+  if (offset + sizeof(entry) > header->capacity)
+    goto miss;
+  memcpy(&entry, cache->ring + offset, sizeof(entry));
+
+  size = entry_size(entry.input_len, entry.extensions_len, entry.value_len);
+  if (entry.hash != hash || entry.options != key->options ||
+      entry.input_len != key->input_len ||
+      entry.extensions_len != key->extensions_len ||
+      offset + size > header->capacity || !entry_live(header, pos, size))
+    goto miss;
+
+  data = cache->ring + offset + sizeof(entry);
+  if (memcmp(data, key->input, key->input_len) != 0 ||
+      memcmp(data + key->input_len, key->extensions, key->extensions_len) != 0)
+    goto miss;
+
+  cmark_strbuf_put(out, data + key->input_len + key->extensions_len,
+                   (bufsize_t)entry.value_len);
+
+  // Everything read above must be checked against a writer that came
+  // along meanwhile.
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (!entry_live(header, pos, size)) {
+    cmark_strbuf_truncate(out, start);
+    goto miss;
+  }
+
+  __atomic_fetch_add(&header->hits, 1, __ATOMIC_RELAXED);
+  return 1;
+
+miss:
+  __atomic_fetch_add(&header->misses, 1, __ATOMIC_RELAXED);
+  return 0;
+}
+
+static int try_lock(cache_header *header) {
+  int32_t self = (int32_t)getpid();
+  int32_t owner = 0;
+
+  if (__atomic_compare_exchange_n(&header->lock, &owner, self, false,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return 1;
+
+  // A writer that died holding the lock would block all writes for good.
+  if (owner != self && kill(owner, 0) == -1 && errno == ESRCH)
+    return __atomic_compare_exchange_n(&header->lock, &owner, self, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+
+  return 0;
+}
+
+int cmark_render_cache_put(cmark_render_cache *cache,
+                           const cmark_render_cache_key *key,
+                           const char *value, size_t value_len) {
+  cache_header *header = cache->header;
+  uint64_t size, pos, offset;
+  unsigned char *data;
+  cache_entry entry;
+
+  if (key->input_len > UINT32_MAX || key->extensions_len > UINT32_MAX ||
+      value_len > UINT32_MAX)
+    return 0;
+
+  size = entry_size(key->input_len, key->extensions_len, value_len);
+  if (size > header->capacity / MAX_ENTRY_SHARE || !try_lock(header))
+    return 0;
+
+  // Entries never wrap around the end of the ring.
+  pos = header->write_end;
+  if (pos % header->capacity + size > header->capacity)
+    pos += header->capacity - pos % header->capacity;
+  offset = pos % header->capacity;
+
+  // Claim the space before touching it, so that readers of the entries
+  // being overwritten notice.
+  __atomic_store_n(&header->write_end, pos + size, __ATOMIC_RELEASE);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  entry.hash = key_hash(key);
+  entry.options = key->options;
+  entry.input_len = (uint32_t)key->input_len;
+  entry.extensions_len = (uint32_t)key->extensions_len;
+  entry.value_len = (uint32_t)value_len;
+
+  data = cache->ring + offset;
+  memcpy(data, &entry, sizeof(entry));
+  data += sizeof(entry);
+  memcpy(data, key->input, key->input_len);
+  data += key->input_len;
+  memcpy(data, key->extensions, key->extensions_len);
+  data += key->extensions_len;
+  memcpy(data, value, value_len);
+
+  __atomic_store_n(&cache->buckets[entry.hash % header->n_buckets], pos + 1,
+                   __ATOMIC_RELEASE);
+  __atomic_store_n(&header->lock, 0, __ATOMIC_RELEASE);
+  __atomic_fetch_add(&header->stores, 1, __ATOMIC_RELAXED);
+
+  return 1;
+}
+
+void cmark_render_cache_get_stats(cmark_render_cache *cache,
+                                  cmark_render_cache_stats *stats) {
+  cache_header *header = cache->header;
+
+  stats->hits = __atomic_load_n(&header->hits, __ATOMIC_RELAXED);
+  stats->misses = __atomic_load_n(&header->misses, __ATOMIC_RELAXED);
+  stats->stores = __atomic_load_n(&header->stores, __ATOMIC_RELAXED);
+  stats->capacity = header->capacity;
+  stats->written = __atomic_load_n(&header->write_end, __ATOMIC_RELAXED);
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef CMARK_RENDER_CACHE_H
+#define CMARK_RENDER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "buffer.h"
+
+/** A cache of rendered output in an anonymous shared mapping. Create it
+ * before forking, and every child process shares it.
+ *
+ * Entries are appended to a ring buffer, so the oldest ones are evicted
+ * first, and a hash index points at the latest entry for each bucket.
+ * Lookups take no lock: they copy the entry out and then check that no
+ * writer reclaimed its space meanwhile. Writers serialize on a spinlock,
+ * and give up rather than wait for it.
+ */
+typedef struct cmark_render_cache cmark_render_cache;
+
+/** The key of an entry. Inputs are compared in full, not just by hash. */
+typedef struct {
+  const char *input;
+  size_t input_len;
+  int options;
+  const char *extensions; /* e.g. the names joined with ',' */
+  size_t extensions_len;
+} cmark_render_cache_key;
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t stores;
+  uint64_t capacity;
+  uint64_t written;
+} cmark_render_cache_stats;
+
+/** Maps 'capacity' bytes of shared memory; returns NULL on failure. */
+cmark_render_cache *cmark_render_cache_new(size_t capacity);
+
+/** Unmaps the cache from the calling process. */
+void cmark_render_cache_free(cmark_render_cache *cache);
+
+/** Appends the value cached for 'key' to 'out'. Returns 1 on a hit and 0
+ * on a miss.
+ */
+int cmark_render_cache_get(cmark_render_cache *cache,
+                           const cmark_render_cache_key *key,
+                           cmark_strbuf *out);
+
+/** Stores 'value' for 'key'. Returns 0 if the value is too large for the
+ * cache or another process is writing.
+ */
+int cmark_render_cache_put(cmark_render_cache *cache,
+                           const cmark_render_cache_key *key,
+                           const char *value, size_t value_len);
+
+void cmark_render_cache_get_stats(cmark_render_cache *cache,
+                                  cmark_render_cache_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
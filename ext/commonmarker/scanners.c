@@ -1,37 +1,45 @@
-/* Generated by re2c 1.3 */
+/* Generated by re2c 1.3 from scanners.re, then moved by hand to the
+ * custom input API (YYPEEK, YYSKIP, YYBACKUP, YYRESTORE) that scanners.re
+ * now asks for: every read of the cursor became the matching macro, and the
+ * state machines are otherwise unchanged. Don't edit it further; regenerate
+ * it instead with
+ *
+ *   re2c --case-insensitive -b -i --no-generation-date -8 \
+ *     --encoding-policy substitute -o scanners.c scanners.re
+ */
 #include <stdlib.h>
 #include "chunk.h"
 #include "scanners.h"
 
-bufsize_t _scan_at(bufsize_t (*scanner)(const unsigned char *), cmark_chunk *c, bufsize_t offset)
-{
-	bufsize_t res;
-	unsigned char *ptr = (unsigned char *)c->data;
+// The scanners read through these rather than dereferencing the cursor, so
+// that they stop at 'end' as though the input were NUL-terminated there,
+// without writing a terminator into it: the input may be read-only or shared.
+#define YYPEEK() (p < end ? *p : 0)
+#define YYSKIP() ++p
+#define YYBACKUP() marker = p
+#define YYRESTORE() p = marker
 
-        if (ptr == NULL || offset > c->len) {
-          return 0;
-        } else {
-	  unsigned char lim = ptr[c->len];
+bufsize_t _scan_at(bufsize_t (*scanner)(const unsigned char *, const unsigned char *), cmark_chunk *c, bufsize_t offset)
+{
+	const unsigned char *ptr = c->data;
 
-	  ptr[c->len] = '\0';
-	  res = scanner(ptr + offset);
-	  ptr[c->len] = lim;
-        }
+	if (ptr == NULL || offset > c->len)
+	  return 0;
 
-	return res;
+	return scanner(ptr + offset, ptr + c->len);
 }
 
 
 
 // Try to match a scheme including colon.
-bufsize_t _scan_scheme(const unsigned char *p)
+bufsize_t _scan_scheme(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
 
 {
 	unsigned char yych;
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= '@') goto yy2;
 	if (yych <= 'Z') goto yy4;
 	if (yych <= '`') goto yy2;
@@ -41,7 +49,9 @@ yy2:
 yy3:
 	{ return 0; }
 yy4:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= '+') {
 			if (yych <= '*') goto yy3;
@@ -59,7 +69,8 @@ yy4:
 		}
 	}
 yy5:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych == '+') goto yy7;
@@ -76,10 +87,11 @@ yy5:
 		}
 	}
 yy6:
-	p = marker;
+	YYRESTORE ();
 	goto yy3;
 yy7:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych == '+') goto yy10;
@@ -103,7 +115,8 @@ yy8:
 	++p;
 	{ return (bufsize_t)(p - start); }
 yy10:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -119,7 +132,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -135,7 +149,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -151,7 +166,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -167,7 +183,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -183,7 +200,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -199,7 +217,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -215,7 +234,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -231,7 +251,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -247,7 +268,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -263,7 +285,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -279,7 +302,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -295,7 +319,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -311,7 +336,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -327,7 +353,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -343,7 +370,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -359,7 +387,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -375,7 +404,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -391,7 +421,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -407,7 +438,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -423,7 +455,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -439,7 +472,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -455,7 +489,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -471,7 +506,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -487,7 +523,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -503,7 +540,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -519,7 +557,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -535,7 +574,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy6;
@@ -551,7 +591,8 @@ yy10:
 			if (yych >= '{') goto yy6;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == ':') goto yy8;
 	goto yy6;
 }
@@ -559,7 +600,7 @@ yy10:
 }
 
 // Try to match URI autolink after first <, returning number of chars matched.
-bufsize_t _scan_autolink_uri(const unsigned char *p)
+bufsize_t _scan_autolink_uri(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -600,7 +641,7 @@ bufsize_t _scan_autolink_uri(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= '@') goto yy41;
 	if (yych <= 'Z') goto yy43;
 	if (yych <= '`') goto yy41;
@@ -610,7 +651,9 @@ yy41:
 yy42:
 	{ return 0; }
 yy43:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= '+') {
 			if (yych <= '*') goto yy42;
@@ -628,7 +671,8 @@ yy43:
 		}
 	}
 yy44:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych == '+') goto yy46;
@@ -645,10 +689,11 @@ yy44:
 		}
 	}
 yy45:
-	p = marker;
+	YYRESTORE ();
 	goto yy42;
 yy46:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych == '+') goto yy49;
@@ -669,7 +714,8 @@ yy46:
 		}
 	}
 yy47:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy47;
 	}
@@ -695,7 +741,8 @@ yy47:
 		}
 	}
 yy49:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych == '+') goto yy59;
@@ -719,42 +766,50 @@ yy50:
 	++p;
 	{ return (bufsize_t)(p - start); }
 yy52:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy45;
 	if (yych <= 0xBF) goto yy47;
 	goto yy45;
 yy53:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy45;
 	if (yych <= 0xBF) goto yy52;
 	goto yy45;
 yy54:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy45;
 	if (yych <= 0xBF) goto yy52;
 	goto yy45;
 yy55:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy45;
 	if (yych <= 0x9F) goto yy52;
 	goto yy45;
 yy56:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy45;
 	if (yych <= 0xBF) goto yy54;
 	goto yy45;
 yy57:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy45;
 	if (yych <= 0xBF) goto yy54;
 	goto yy45;
 yy58:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy45;
 	if (yych <= 0x8F) goto yy54;
 	goto yy45;
 yy59:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -770,7 +825,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -786,7 +842,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -802,7 +859,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -818,7 +876,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -834,7 +893,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -850,7 +910,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -866,7 +927,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -882,7 +944,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -898,7 +961,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -914,7 +978,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -930,7 +995,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -946,7 +1012,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -962,7 +1029,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -978,7 +1046,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -994,7 +1063,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1010,7 +1080,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1026,7 +1097,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1042,7 +1114,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1058,7 +1131,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1074,7 +1148,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1090,7 +1165,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1106,7 +1182,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1122,7 +1199,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1138,7 +1216,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1154,7 +1233,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1170,7 +1250,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= ',') {
 			if (yych != '+') goto yy45;
@@ -1186,7 +1267,8 @@ yy59:
 			if (yych >= '{') goto yy45;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == ':') goto yy47;
 	goto yy45;
 }
@@ -1194,7 +1276,7 @@ yy59:
 }
 
 // Try to match email autolink after first <, returning num of chars matched.
-bufsize_t _scan_autolink_email(const unsigned char *p)
+bufsize_t _scan_autolink_email(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -1235,7 +1317,7 @@ bufsize_t _scan_autolink_email(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych <= '\'') {
 			if (yych == '!') goto yy91;
@@ -1262,7 +1344,9 @@ yy89:
 yy90:
 	{ return 0; }
 yy91:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= ',') {
 		if (yych <= '"') {
 			if (yych == '!') goto yy93;
@@ -1286,7 +1370,8 @@ yy91:
 		}
 	}
 yy92:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy93:
 	if (yybm[0+yych] & 128) {
 		goto yy92;
@@ -1294,10 +1379,11 @@ yy93:
 	if (yych <= '>') goto yy94;
 	if (yych <= '@') goto yy95;
 yy94:
-	p = marker;
+	YYRESTORE ();
 	goto yy90;
 yy95:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych <= '/') goto yy94;
 		if (yych >= ':') goto yy94;
@@ -1307,7 +1393,8 @@ yy95:
 		if (yych >= '{') goto yy94;
 	}
 yy96:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1328,7 +1415,8 @@ yy96:
 			goto yy94;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy101;
 		if (yych <= '/') goto yy94;
@@ -1344,7 +1432,8 @@ yy96:
 		}
 	}
 yy98:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1370,7 +1459,8 @@ yy99:
 	++p;
 	{ return (bufsize_t)(p - start); }
 yy101:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy103;
 		if (yych <= '/') goto yy94;
@@ -1386,7 +1476,8 @@ yy101:
 		}
 	}
 yy102:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1408,7 +1499,8 @@ yy102:
 		}
 	}
 yy103:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy105;
 		if (yych <= '/') goto yy94;
@@ -1424,7 +1516,8 @@ yy103:
 		}
 	}
 yy104:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1446,7 +1539,8 @@ yy104:
 		}
 	}
 yy105:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy107;
 		if (yych <= '/') goto yy94;
@@ -1462,7 +1556,8 @@ yy105:
 		}
 	}
 yy106:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1484,7 +1579,8 @@ yy106:
 		}
 	}
 yy107:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy109;
 		if (yych <= '/') goto yy94;
@@ -1500,7 +1596,8 @@ yy107:
 		}
 	}
 yy108:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1522,7 +1619,8 @@ yy108:
 		}
 	}
 yy109:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy111;
 		if (yych <= '/') goto yy94;
@@ -1538,7 +1636,8 @@ yy109:
 		}
 	}
 yy110:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1560,7 +1659,8 @@ yy110:
 		}
 	}
 yy111:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy113;
 		if (yych <= '/') goto yy94;
@@ -1576,7 +1676,8 @@ yy111:
 		}
 	}
 yy112:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1598,7 +1699,8 @@ yy112:
 		}
 	}
 yy113:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy115;
 		if (yych <= '/') goto yy94;
@@ -1614,7 +1716,8 @@ yy113:
 		}
 	}
 yy114:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1636,7 +1739,8 @@ yy114:
 		}
 	}
 yy115:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy117;
 		if (yych <= '/') goto yy94;
@@ -1652,7 +1756,8 @@ yy115:
 		}
 	}
 yy116:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1674,7 +1779,8 @@ yy116:
 		}
 	}
 yy117:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy119;
 		if (yych <= '/') goto yy94;
@@ -1690,7 +1796,8 @@ yy117:
 		}
 	}
 yy118:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1712,7 +1819,8 @@ yy118:
 		}
 	}
 yy119:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy121;
 		if (yych <= '/') goto yy94;
@@ -1728,7 +1836,8 @@ yy119:
 		}
 	}
 yy120:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1750,7 +1859,8 @@ yy120:
 		}
 	}
 yy121:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy123;
 		if (yych <= '/') goto yy94;
@@ -1766,7 +1876,8 @@ yy121:
 		}
 	}
 yy122:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1788,7 +1899,8 @@ yy122:
 		}
 	}
 yy123:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy125;
 		if (yych <= '/') goto yy94;
@@ -1804,7 +1916,8 @@ yy123:
 		}
 	}
 yy124:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1826,7 +1939,8 @@ yy124:
 		}
 	}
 yy125:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy127;
 		if (yych <= '/') goto yy94;
@@ -1842,7 +1956,8 @@ yy125:
 		}
 	}
 yy126:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1864,7 +1979,8 @@ yy126:
 		}
 	}
 yy127:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy129;
 		if (yych <= '/') goto yy94;
@@ -1880,7 +1996,8 @@ yy127:
 		}
 	}
 yy128:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1902,7 +2019,8 @@ yy128:
 		}
 	}
 yy129:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy131;
 		if (yych <= '/') goto yy94;
@@ -1918,7 +2036,8 @@ yy129:
 		}
 	}
 yy130:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1940,7 +2059,8 @@ yy130:
 		}
 	}
 yy131:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy133;
 		if (yych <= '/') goto yy94;
@@ -1956,7 +2076,8 @@ yy131:
 		}
 	}
 yy132:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -1978,7 +2099,8 @@ yy132:
 		}
 	}
 yy133:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy135;
 		if (yych <= '/') goto yy94;
@@ -1994,7 +2116,8 @@ yy133:
 		}
 	}
 yy134:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2016,7 +2139,8 @@ yy134:
 		}
 	}
 yy135:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy137;
 		if (yych <= '/') goto yy94;
@@ -2032,7 +2156,8 @@ yy135:
 		}
 	}
 yy136:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2054,7 +2179,8 @@ yy136:
 		}
 	}
 yy137:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy139;
 		if (yych <= '/') goto yy94;
@@ -2070,7 +2196,8 @@ yy137:
 		}
 	}
 yy138:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2092,7 +2219,8 @@ yy138:
 		}
 	}
 yy139:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy141;
 		if (yych <= '/') goto yy94;
@@ -2108,7 +2236,8 @@ yy139:
 		}
 	}
 yy140:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2130,7 +2259,8 @@ yy140:
 		}
 	}
 yy141:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy143;
 		if (yych <= '/') goto yy94;
@@ -2146,7 +2276,8 @@ yy141:
 		}
 	}
 yy142:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2168,7 +2299,8 @@ yy142:
 		}
 	}
 yy143:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy145;
 		if (yych <= '/') goto yy94;
@@ -2184,7 +2316,8 @@ yy143:
 		}
 	}
 yy144:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2206,7 +2339,8 @@ yy144:
 		}
 	}
 yy145:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy147;
 		if (yych <= '/') goto yy94;
@@ -2222,7 +2356,8 @@ yy145:
 		}
 	}
 yy146:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2244,7 +2379,8 @@ yy146:
 		}
 	}
 yy147:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy149;
 		if (yych <= '/') goto yy94;
@@ -2260,7 +2396,8 @@ yy147:
 		}
 	}
 yy148:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2282,7 +2419,8 @@ yy148:
 		}
 	}
 yy149:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy151;
 		if (yych <= '/') goto yy94;
@@ -2298,7 +2436,8 @@ yy149:
 		}
 	}
 yy150:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2320,7 +2459,8 @@ yy150:
 		}
 	}
 yy151:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy153;
 		if (yych <= '/') goto yy94;
@@ -2336,7 +2476,8 @@ yy151:
 		}
 	}
 yy152:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2358,7 +2499,8 @@ yy152:
 		}
 	}
 yy153:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy155;
 		if (yych <= '/') goto yy94;
@@ -2374,7 +2516,8 @@ yy153:
 		}
 	}
 yy154:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2396,7 +2539,8 @@ yy154:
 		}
 	}
 yy155:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy157;
 		if (yych <= '/') goto yy94;
@@ -2412,7 +2556,8 @@ yy155:
 		}
 	}
 yy156:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2434,7 +2579,8 @@ yy156:
 		}
 	}
 yy157:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy159;
 		if (yych <= '/') goto yy94;
@@ -2450,7 +2596,8 @@ yy157:
 		}
 	}
 yy158:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2472,7 +2619,8 @@ yy158:
 		}
 	}
 yy159:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy161;
 		if (yych <= '/') goto yy94;
@@ -2488,7 +2636,8 @@ yy159:
 		}
 	}
 yy160:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2510,7 +2659,8 @@ yy160:
 		}
 	}
 yy161:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy163;
 		if (yych <= '/') goto yy94;
@@ -2526,7 +2676,8 @@ yy161:
 		}
 	}
 yy162:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2548,7 +2699,8 @@ yy162:
 		}
 	}
 yy163:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy165;
 		if (yych <= '/') goto yy94;
@@ -2564,7 +2716,8 @@ yy163:
 		}
 	}
 yy164:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2586,7 +2739,8 @@ yy164:
 		}
 	}
 yy165:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy167;
 		if (yych <= '/') goto yy94;
@@ -2602,7 +2756,8 @@ yy165:
 		}
 	}
 yy166:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2624,7 +2779,8 @@ yy166:
 		}
 	}
 yy167:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy169;
 		if (yych <= '/') goto yy94;
@@ -2640,7 +2796,8 @@ yy167:
 		}
 	}
 yy168:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2662,7 +2819,8 @@ yy168:
 		}
 	}
 yy169:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy171;
 		if (yych <= '/') goto yy94;
@@ -2678,7 +2836,8 @@ yy169:
 		}
 	}
 yy170:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2700,7 +2859,8 @@ yy170:
 		}
 	}
 yy171:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy173;
 		if (yych <= '/') goto yy94;
@@ -2716,7 +2876,8 @@ yy171:
 		}
 	}
 yy172:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2738,7 +2899,8 @@ yy172:
 		}
 	}
 yy173:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy175;
 		if (yych <= '/') goto yy94;
@@ -2754,7 +2916,8 @@ yy173:
 		}
 	}
 yy174:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2776,7 +2939,8 @@ yy174:
 		}
 	}
 yy175:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy177;
 		if (yych <= '/') goto yy94;
@@ -2792,7 +2956,8 @@ yy175:
 		}
 	}
 yy176:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2814,7 +2979,8 @@ yy176:
 		}
 	}
 yy177:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy179;
 		if (yych <= '/') goto yy94;
@@ -2830,7 +2996,8 @@ yy177:
 		}
 	}
 yy178:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2852,7 +3019,8 @@ yy178:
 		}
 	}
 yy179:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy181;
 		if (yych <= '/') goto yy94;
@@ -2868,7 +3036,8 @@ yy179:
 		}
 	}
 yy180:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2890,7 +3059,8 @@ yy180:
 		}
 	}
 yy181:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy183;
 		if (yych <= '/') goto yy94;
@@ -2906,7 +3076,8 @@ yy181:
 		}
 	}
 yy182:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2928,7 +3099,8 @@ yy182:
 		}
 	}
 yy183:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy185;
 		if (yych <= '/') goto yy94;
@@ -2944,7 +3116,8 @@ yy183:
 		}
 	}
 yy184:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -2966,7 +3139,8 @@ yy184:
 		}
 	}
 yy185:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy187;
 		if (yych <= '/') goto yy94;
@@ -2982,7 +3156,8 @@ yy185:
 		}
 	}
 yy186:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3004,7 +3179,8 @@ yy186:
 		}
 	}
 yy187:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy189;
 		if (yych <= '/') goto yy94;
@@ -3020,7 +3196,8 @@ yy187:
 		}
 	}
 yy188:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3042,7 +3219,8 @@ yy188:
 		}
 	}
 yy189:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy191;
 		if (yych <= '/') goto yy94;
@@ -3058,7 +3236,8 @@ yy189:
 		}
 	}
 yy190:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3080,7 +3259,8 @@ yy190:
 		}
 	}
 yy191:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy193;
 		if (yych <= '/') goto yy94;
@@ -3096,7 +3276,8 @@ yy191:
 		}
 	}
 yy192:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3118,7 +3299,8 @@ yy192:
 		}
 	}
 yy193:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy195;
 		if (yych <= '/') goto yy94;
@@ -3134,7 +3316,8 @@ yy193:
 		}
 	}
 yy194:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3156,7 +3339,8 @@ yy194:
 		}
 	}
 yy195:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy197;
 		if (yych <= '/') goto yy94;
@@ -3172,7 +3356,8 @@ yy195:
 		}
 	}
 yy196:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3194,7 +3379,8 @@ yy196:
 		}
 	}
 yy197:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy199;
 		if (yych <= '/') goto yy94;
@@ -3210,7 +3396,8 @@ yy197:
 		}
 	}
 yy198:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3232,7 +3419,8 @@ yy198:
 		}
 	}
 yy199:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy201;
 		if (yych <= '/') goto yy94;
@@ -3248,7 +3436,8 @@ yy199:
 		}
 	}
 yy200:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3270,7 +3459,8 @@ yy200:
 		}
 	}
 yy201:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy203;
 		if (yych <= '/') goto yy94;
@@ -3286,7 +3476,8 @@ yy201:
 		}
 	}
 yy202:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3308,7 +3499,8 @@ yy202:
 		}
 	}
 yy203:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy205;
 		if (yych <= '/') goto yy94;
@@ -3324,7 +3516,8 @@ yy203:
 		}
 	}
 yy204:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3346,7 +3539,8 @@ yy204:
 		}
 	}
 yy205:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy207;
 		if (yych <= '/') goto yy94;
@@ -3362,7 +3556,8 @@ yy205:
 		}
 	}
 yy206:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3384,7 +3579,8 @@ yy206:
 		}
 	}
 yy207:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy209;
 		if (yych <= '/') goto yy94;
@@ -3400,7 +3596,8 @@ yy207:
 		}
 	}
 yy208:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3422,7 +3619,8 @@ yy208:
 		}
 	}
 yy209:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy211;
 		if (yych <= '/') goto yy94;
@@ -3438,7 +3636,8 @@ yy209:
 		}
 	}
 yy210:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3460,7 +3659,8 @@ yy210:
 		}
 	}
 yy211:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy213;
 		if (yych <= '/') goto yy94;
@@ -3476,7 +3676,8 @@ yy211:
 		}
 	}
 yy212:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3498,7 +3699,8 @@ yy212:
 		}
 	}
 yy213:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy215;
 		if (yych <= '/') goto yy94;
@@ -3514,7 +3716,8 @@ yy213:
 		}
 	}
 yy214:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3536,7 +3739,8 @@ yy214:
 		}
 	}
 yy215:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy217;
 		if (yych <= '/') goto yy94;
@@ -3552,7 +3756,8 @@ yy215:
 		}
 	}
 yy216:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3574,7 +3779,8 @@ yy216:
 		}
 	}
 yy217:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '9') {
 		if (yych == '-') goto yy219;
 		if (yych <= '/') goto yy94;
@@ -3590,7 +3796,8 @@ yy217:
 		}
 	}
 yy218:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= ',') goto yy94;
@@ -3612,7 +3819,8 @@ yy218:
 		}
 	}
 yy219:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych <= '/') goto yy94;
 		if (yych <= '9') goto yy221;
@@ -3624,7 +3832,8 @@ yy219:
 		goto yy94;
 	}
 yy220:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= '.') {
 			if (yych <= '-') goto yy94;
@@ -3643,7 +3852,8 @@ yy220:
 		}
 	}
 yy221:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '.') goto yy95;
 	if (yych == '>') goto yy99;
 	goto yy94;
@@ -3652,7 +3862,7 @@ yy221:
 }
 
 // Try to match an HTML tag after first <, returning num of chars matched.
-bufsize_t _scan_html_tag(const unsigned char *p)
+bufsize_t _scan_html_tag(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -3727,7 +3937,7 @@ bufsize_t _scan_html_tag(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= '>') {
 		if (yych <= '!') {
 			if (yych >= '!') goto yy226;
@@ -3748,7 +3958,9 @@ yy224:
 yy225:
 	{ return 0; }
 yy226:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[256+yych] & 32) {
 		goto yy232;
 	}
@@ -3757,21 +3969,27 @@ yy226:
 	if (yych <= '[') goto yy234;
 	goto yy225;
 yy227:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '@') goto yy225;
 	if (yych <= 'Z') goto yy235;
 	if (yych <= '`') goto yy225;
 	if (yych <= 'z') goto yy235;
 	goto yy225;
 yy228:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x00) goto yy225;
 	if (yych <= 0x7F) goto yy238;
 	if (yych <= 0xC1) goto yy225;
 	if (yych <= 0xF4) goto yy238;
 	goto yy225;
 yy229:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '.') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy225;
@@ -3795,13 +4013,15 @@ yy229:
 		}
 	}
 yy230:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '-') goto yy254;
 yy231:
-	p = marker;
+	YYRESTORE ();
 	goto yy225;
 yy232:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[256+yych] & 32) {
 		goto yy232;
 	}
@@ -3810,12 +4030,14 @@ yy232:
 	if (yych == ' ') goto yy255;
 	goto yy231;
 yy234:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy257;
 	if (yych == 'c') goto yy257;
 	goto yy231;
 yy235:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[256+yych] & 64) {
 		goto yy235;
 	}
@@ -3829,7 +4051,8 @@ yy235:
 		goto yy231;
 	}
 yy237:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy238:
 	if (yybm[256+yych] & 128) {
 		goto yy237;
@@ -3854,7 +4077,8 @@ yy238:
 			goto yy231;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0xE0) {
 		if (yych <= '>') {
 			if (yych <= 0x00) goto yy231;
@@ -3877,42 +4101,50 @@ yy238:
 		}
 	}
 yy240:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy237;
 	goto yy231;
 yy241:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy240;
 	goto yy231;
 yy242:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy240;
 	goto yy231;
 yy243:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy240;
 	goto yy231;
 yy244:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy242;
 	goto yy231;
 yy245:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy242;
 	goto yy231;
 yy246:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy242;
 	goto yy231;
 yy247:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 1) {
 		goto yy247;
 	}
@@ -3937,7 +4169,8 @@ yy247:
 		}
 	}
 yy249:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy250:
 	if (yybm[0+yych] & 1) {
 		goto yy247;
@@ -3963,18 +4196,21 @@ yy250:
 		}
 	}
 yy251:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych != '>') goto yy231;
 yy252:
 	++p;
 	{ return (bufsize_t)(p - start); }
 yy254:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '-') goto yy264;
 	if (yych == '>') goto yy231;
 	goto yy263;
 yy255:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 2) {
 		goto yy255;
 	}
@@ -4000,12 +4236,14 @@ yy255:
 		}
 	}
 yy257:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy279;
 	if (yych == 'd') goto yy279;
 	goto yy231;
 yy258:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x1F) {
 		if (yych <= 0x08) goto yy231;
 		if (yych <= '\r') goto yy258;
@@ -4016,7 +4254,8 @@ yy258:
 		goto yy231;
 	}
 yy260:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 4) {
 		goto yy260;
 	}
@@ -4039,7 +4278,8 @@ yy260:
 		}
 	}
 yy262:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy263:
 	if (yybm[0+yych] & 8) {
 		goto yy262;
@@ -4066,87 +4306,104 @@ yy263:
 		}
 	}
 yy264:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '-') goto yy251;
 	if (yych == '>') goto yy231;
 	goto yy263;
 yy265:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy262;
 	goto yy231;
 yy266:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy265;
 	goto yy231;
 yy267:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy265;
 	goto yy231;
 yy268:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy265;
 	goto yy231;
 yy269:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy267;
 	goto yy231;
 yy270:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy267;
 	goto yy231;
 yy271:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy267;
 	goto yy231;
 yy272:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy255;
 	goto yy231;
 yy273:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy272;
 	goto yy231;
 yy274:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy272;
 	goto yy231;
 yy275:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy272;
 	goto yy231;
 yy276:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy274;
 	goto yy231;
 yy277:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy274;
 	goto yy231;
 yy278:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy274;
 	goto yy231;
 yy279:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy285;
 	if (yych == 'a') goto yy285;
 	goto yy231;
 yy280:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '<') {
 		if (yych <= ' ') {
 			if (yych <= 0x08) goto yy231;
@@ -4180,7 +4437,8 @@ yy280:
 		}
 	}
 yy282:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 16) {
 		goto yy286;
 	}
@@ -4207,7 +4465,8 @@ yy282:
 		}
 	}
 yy284:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 8) {
 		goto yy262;
 	}
@@ -4233,12 +4492,14 @@ yy284:
 		}
 	}
 yy285:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy299;
 	if (yych == 't') goto yy299;
 	goto yy231;
 yy286:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 16) {
 		goto yy286;
 	}
@@ -4265,7 +4526,8 @@ yy286:
 		}
 	}
 yy288:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy288;
 	}
@@ -4291,7 +4553,8 @@ yy288:
 		}
 	}
 yy290:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy290;
 	}
@@ -4317,47 +4580,56 @@ yy290:
 		}
 	}
 yy292:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy286;
 	goto yy231;
 yy293:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy292;
 	goto yy231;
 yy294:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy292;
 	goto yy231;
 yy295:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy292;
 	goto yy231;
 yy296:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy294;
 	goto yy231;
 yy297:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy294;
 	goto yy231;
 yy298:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy294;
 	goto yy231;
 yy299:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy315;
 	if (yych == 'a') goto yy315;
 	goto yy231;
 yy300:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 1) {
 		goto yy247;
 	}
@@ -4365,80 +4637,96 @@ yy300:
 	if (yych == '>') goto yy252;
 	goto yy231;
 yy301:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy288;
 	goto yy231;
 yy302:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy301;
 	goto yy231;
 yy303:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy301;
 	goto yy231;
 yy304:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy301;
 	goto yy231;
 yy305:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy303;
 	goto yy231;
 yy306:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy303;
 	goto yy231;
 yy307:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy303;
 	goto yy231;
 yy308:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy290;
 	goto yy231;
 yy309:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy308;
 	goto yy231;
 yy310:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy308;
 	goto yy231;
 yy311:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy308;
 	goto yy231;
 yy312:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy310;
 	goto yy231;
 yy313:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy310;
 	goto yy231;
 yy314:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy310;
 	goto yy231;
 yy315:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych != '[') goto yy231;
 yy316:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy316;
 	}
@@ -4462,7 +4750,8 @@ yy316:
 			goto yy231;
 		}
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy316;
 	}
@@ -4488,42 +4777,50 @@ yy316:
 		}
 	}
 yy319:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy316;
 	goto yy231;
 yy320:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy231;
 	if (yych <= 0xBF) goto yy319;
 	goto yy231;
 yy321:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy319;
 	goto yy231;
 yy322:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x9F) goto yy319;
 	goto yy231;
 yy323:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy231;
 	if (yych <= 0xBF) goto yy321;
 	goto yy231;
 yy324:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0xBF) goto yy321;
 	goto yy231;
 yy325:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy231;
 	if (yych <= 0x8F) goto yy321;
 	goto yy231;
 yy326:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0xE0) {
 		if (yych <= '>') {
 			if (yych <= 0x00) goto yy231;
@@ -4551,7 +4848,7 @@ yy326:
 }
 
 // Try to (liberally) match an HTML tag after first <, returning num of chars matched.
-bufsize_t _scan_liberal_html_tag(const unsigned char *p)
+bufsize_t _scan_liberal_html_tag(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -4593,7 +4890,7 @@ bufsize_t _scan_liberal_html_tag(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= 0xE0) {
 		if (yych <= '\n') {
 			if (yych <= 0x00) goto yy329;
@@ -4620,7 +4917,9 @@ yy330:
 	{ return 0; }
 yy331:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '\n') {
 		if (yych <= 0x00) goto yy330;
 		if (yych <= '\t') goto yy340;
@@ -4633,48 +4932,63 @@ yy331:
 	}
 yy332:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy330;
 	if (yych <= 0xBF) goto yy339;
 	goto yy330;
 yy333:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy330;
 	if (yych <= 0xBF) goto yy345;
 	goto yy330;
 yy334:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy330;
 	if (yych <= 0xBF) goto yy345;
 	goto yy330;
 yy335:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy330;
 	if (yych <= 0x9F) goto yy345;
 	goto yy330;
 yy336:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy330;
 	if (yych <= 0xBF) goto yy347;
 	goto yy330;
 yy337:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy330;
 	if (yych <= 0xBF) goto yy347;
 	goto yy330;
 yy338:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy330;
 	if (yych <= 0x8F) goto yy347;
 	goto yy330;
 yy339:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy340:
 	if (yybm[0+yych] & 64) {
 		goto yy339;
@@ -4699,7 +5013,7 @@ yy340:
 		}
 	}
 yy341:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy330;
 	} else {
@@ -4707,7 +5021,9 @@ yy341:
 	}
 yy342:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy339;
 	}
@@ -4733,37 +5049,44 @@ yy342:
 yy344:
 	{ return (bufsize_t)(p - start); }
 yy345:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy341;
 	if (yych <= 0xBF) goto yy339;
 	goto yy341;
 yy346:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy341;
 	if (yych <= 0xBF) goto yy345;
 	goto yy341;
 yy347:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy341;
 	if (yych <= 0xBF) goto yy345;
 	goto yy341;
 yy348:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy341;
 	if (yych <= 0x9F) goto yy345;
 	goto yy341;
 yy349:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy341;
 	if (yych <= 0xBF) goto yy347;
 	goto yy341;
 yy350:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy341;
 	if (yych <= 0xBF) goto yy347;
 	goto yy341;
 yy351:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy341;
 	if (yych <= 0x8F) goto yy347;
 	goto yy341;
@@ -4774,19 +5097,21 @@ yy351:
 // Try to match an HTML block tag start line, returning
 // an integer code for the type of block (1-6, matching the spec).
 // #7 is handled by a separate function, below.
-bufsize_t _scan_html_block_start(const unsigned char *p)
+bufsize_t _scan_html_block_start(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
 
 {
 	unsigned char yych;
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '<') goto yy356;
 	++p;
 yy355:
 	{ return 0; }
 yy356:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	switch (yych) {
 	case '!':	goto yy357;
 	case '/':	goto yy359;
@@ -4824,7 +5149,8 @@ yy356:
 	default:	goto yy355;
 	}
 yy357:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych == '-') goto yy377;
 	} else {
@@ -4832,10 +5158,11 @@ yy357:
 		if (yych <= '[') goto yy380;
 	}
 yy358:
-	p = marker;
+	YYRESTORE ();
 	goto yy355;
 yy359:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	switch (yych) {
 	case 'A':
 	case 'a':	goto yy362;
@@ -4873,7 +5200,8 @@ yy360:
 	++p;
 	{ return 3; }
 yy362:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'S') {
 		if (yych <= 'D') {
 			if (yych <= 'C') goto yy358;
@@ -4894,7 +5222,8 @@ yy362:
 		}
 	}
 yy363:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'O') {
 		if (yych <= 'K') {
 			if (yych == 'A') goto yy386;
@@ -4915,7 +5244,8 @@ yy363:
 		}
 	}
 yy364:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'O') {
 		if (yych <= 'D') {
 			if (yych == 'A') goto yy389;
@@ -4936,7 +5266,8 @@ yy364:
 		}
 	}
 yy365:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	switch (yych) {
 	case 'D':
 	case 'L':
@@ -4951,7 +5282,8 @@ yy365:
 	default:	goto yy358;
 	}
 yy366:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'R') {
 		if (yych <= 'N') {
 			if (yych == 'I') goto yy395;
@@ -4972,7 +5304,8 @@ yy366:
 		}
 	}
 yy367:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'S') {
 		if (yych <= 'D') {
 			if (yych <= '0') goto yy358;
@@ -4995,12 +5328,14 @@ yy367:
 		}
 	}
 yy368:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'F') goto yy400;
 	if (yych == 'f') goto yy400;
 	goto yy358;
 yy369:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'I') {
 		if (yych == 'E') goto yy401;
 		if (yych <= 'H') goto yy358;
@@ -5015,7 +5350,8 @@ yy369:
 		}
 	}
 yy370:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'E') {
 		if (yych == 'A') goto yy403;
 		if (yych <= 'D') goto yy358;
@@ -5030,7 +5366,8 @@ yy370:
 		}
 	}
 yy371:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'O') {
 		if (yych == 'A') goto yy405;
 		if (yych <= 'N') goto yy358;
@@ -5045,7 +5382,8 @@ yy371:
 		}
 	}
 yy372:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'P') {
 		if (yych == 'L') goto yy392;
 		if (yych <= 'O') goto yy358;
@@ -5060,7 +5398,8 @@ yy372:
 		}
 	}
 yy373:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '>') {
 		if (yych <= ' ') {
 			if (yych <= 0x08) goto yy358;
@@ -5088,7 +5427,8 @@ yy373:
 		}
 	}
 yy374:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'U') {
 		if (yych <= 'D') {
 			if (yych == 'C') goto yy413;
@@ -5112,7 +5452,8 @@ yy374:
 		}
 	}
 yy375:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	switch (yych) {
 	case 'A':
 	case 'a':	goto yy417;
@@ -5131,24 +5472,28 @@ yy375:
 	default:	goto yy358;
 	}
 yy376:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy392;
 	if (yych == 'l') goto yy392;
 	goto yy358;
 yy377:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '-') goto yy423;
 	goto yy358;
 yy378:
 	++p;
 	{ return 4; }
 yy380:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy425;
 	if (yych == 'c') goto yy425;
 	goto yy358;
 yy381:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5170,7 +5515,8 @@ yy381:
 		}
 	}
 yy382:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'U') {
 		if (yych == 'E') goto yy414;
 		if (yych <= 'T') goto yy358;
@@ -5185,52 +5531,62 @@ yy382:
 		}
 	}
 yy383:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy426;
 	if (yych == 'd') goto yy426;
 	goto yy358;
 yy384:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy427;
 	if (yych == 't') goto yy427;
 	goto yy358;
 yy385:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy428;
 	if (yych == 'i') goto yy428;
 	goto yy358;
 yy386:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'S') goto yy429;
 	if (yych == 's') goto yy429;
 	goto yy358;
 yy387:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy430;
 	if (yych == 'o') goto yy430;
 	goto yy358;
 yy388:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy431;
 	if (yych == 'd') goto yy431;
 	goto yy358;
 yy389:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'P') goto yy432;
 	if (yych == 'p') goto yy432;
 	goto yy358;
 yy390:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'N') goto yy433;
 	if (yych == 'n') goto yy433;
 	goto yy358;
 yy391:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy434;
 	if (yych == 'l') goto yy434;
 	goto yy358;
 yy392:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ' ') {
 		if (yych <= 0x08) goto yy358;
 		if (yych <= '\r') goto yy408;
@@ -5246,12 +5602,14 @@ yy392:
 		}
 	}
 yy393:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy435;
 	if (yych == 't') goto yy435;
 	goto yy358;
 yy394:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'V') {
 		if (yych <= 'Q') {
 			if (yych == 'A') goto yy436;
@@ -5272,7 +5630,8 @@ yy394:
 		}
 	}
 yy395:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'G') {
 		if (yych == 'E') goto yy437;
 		if (yych <= 'F') goto yy358;
@@ -5287,7 +5646,8 @@ yy395:
 		}
 	}
 yy396:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'R') {
 		if (yych == 'O') goto yy433;
 		if (yych <= 'Q') goto yy358;
@@ -5302,32 +5662,38 @@ yy396:
 		}
 	}
 yy397:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy440;
 	if (yych == 'a') goto yy440;
 	goto yy358;
 yy398:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy441;
 	if (yych == 'a') goto yy441;
 	goto yy358;
 yy399:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy376;
 	if (yych == 'm') goto yy376;
 	goto yy358;
 yy400:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy442;
 	if (yych == 'r') goto yy442;
 	goto yy358;
 yy401:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'G') goto yy443;
 	if (yych == 'g') goto yy443;
 	goto yy358;
 yy402:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5349,27 +5715,32 @@ yy402:
 		}
 	}
 yy403:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy445;
 	if (yych == 'i') goto yy445;
 	goto yy358;
 yy404:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'N') goto yy446;
 	if (yych == 'n') goto yy446;
 	goto yy358;
 yy405:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'V') goto yy392;
 	if (yych == 'v') goto yy392;
 	goto yy358;
 yy406:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'F') goto yy447;
 	if (yych == 'f') goto yy447;
 	goto yy358;
 yy407:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy448;
 	if (yych == 't') goto yy448;
 	goto yy358;
@@ -5377,56 +5748,67 @@ yy408:
 	++p;
 	{ return 6; }
 yy410:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '>') goto yy408;
 	goto yy358;
 yy411:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy449;
 	if (yych == 'r') goto yy449;
 	goto yy358;
 yy412:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy450;
 	if (yych == 'e') goto yy450;
 	goto yy358;
 yy413:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy451;
 	if (yych == 'r') goto yy451;
 	goto yy358;
 yy414:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy432;
 	if (yych == 'c') goto yy432;
 	goto yy358;
 yy415:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'Y') goto yy452;
 	if (yych == 'y') goto yy452;
 	goto yy358;
 yy416:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy453;
 	if (yych == 'm') goto yy453;
 	goto yy358;
 yy417:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'B') goto yy454;
 	if (yych == 'b') goto yy454;
 	goto yy358;
 yy418:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy388;
 	if (yych == 'o') goto yy388;
 	goto yy358;
 yy419:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy455;
 	if (yych == 'o') goto yy455;
 	goto yy358;
 yy420:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5448,12 +5830,14 @@ yy420:
 		}
 	}
 yy421:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy454;
 	if (yych == 't') goto yy454;
 	goto yy358;
 yy422:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5478,52 +5862,62 @@ yy423:
 	++p;
 	{ return 2; }
 yy425:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy458;
 	if (yych == 'd') goto yy458;
 	goto yy358;
 yy426:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy459;
 	if (yych == 'r') goto yy459;
 	goto yy358;
 yy427:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy460;
 	if (yych == 'i') goto yy460;
 	goto yy358;
 yy428:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy461;
 	if (yych == 'd') goto yy461;
 	goto yy358;
 yy429:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy462;
 	if (yych == 'e') goto yy462;
 	goto yy358;
 yy430:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy463;
 	if (yych == 'c') goto yy463;
 	goto yy358;
 yy431:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'Y') goto yy392;
 	if (yych == 'y') goto yy392;
 	goto yy358;
 yy432:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy464;
 	if (yych == 't') goto yy464;
 	goto yy358;
 yy433:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy465;
 	if (yych == 't') goto yy465;
 	goto yy358;
 yy434:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5545,22 +5939,26 @@ yy434:
 		}
 	}
 yy435:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy467;
 	if (yych == 'a') goto yy467;
 	goto yy358;
 yy436:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy468;
 	if (yych == 'l') goto yy468;
 	goto yy358;
 yy437:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy469;
 	if (yych == 'l') goto yy469;
 	goto yy358;
 yy438:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'U') {
 		if (yych == 'C') goto yy470;
 		if (yych <= 'T') goto yy358;
@@ -5575,52 +5973,62 @@ yy438:
 		}
 	}
 yy439:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy392;
 	if (yych == 'm') goto yy392;
 	goto yy358;
 yy440:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy472;
 	if (yych == 'm') goto yy472;
 	goto yy358;
 yy441:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy473;
 	if (yych == 'd') goto yy473;
 	goto yy358;
 yy442:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy474;
 	if (yych == 'a') goto yy474;
 	goto yy358;
 yy443:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy475;
 	if (yych == 'e') goto yy475;
 	goto yy358;
 yy444:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'K') goto yy392;
 	if (yych == 'k') goto yy392;
 	goto yy358;
 yy445:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'N') goto yy392;
 	if (yych == 'n') goto yy392;
 	goto yy358;
 yy446:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'U') goto yy476;
 	if (yych == 'u') goto yy476;
 	goto yy358;
 yy447:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy477;
 	if (yych == 'r') goto yy477;
 	goto yy358;
 yy448:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'I') {
 		if (yych == 'G') goto yy466;
 		if (yych <= 'H') goto yy358;
@@ -5635,12 +6043,14 @@ yy448:
 		}
 	}
 yy449:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy439;
 	if (yych == 'a') goto yy439;
 	goto yy358;
 yy450:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x1F) {
 		if (yych <= 0x08) goto yy358;
 		if (yych <= '\r') goto yy479;
@@ -5651,62 +6061,74 @@ yy450:
 		goto yy358;
 	}
 yy451:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy481;
 	if (yych == 'i') goto yy481;
 	goto yy358;
 yy452:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy412;
 	if (yych == 'l') goto yy412;
 	goto yy358;
 yy453:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy482;
 	if (yych == 'm') goto yy482;
 	goto yy358;
 yy454:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy461;
 	if (yych == 'l') goto yy461;
 	goto yy358;
 yy455:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy483;
 	if (yych == 'o') goto yy483;
 	goto yy358;
 yy456:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy484;
 	if (yych == 'a') goto yy484;
 	goto yy358;
 yy457:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy444;
 	if (yych == 'c') goto yy444;
 	goto yy358;
 yy458:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy485;
 	if (yych == 'a') goto yy485;
 	goto yy358;
 yy459:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy486;
 	if (yych == 'e') goto yy486;
 	goto yy358;
 yy460:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy454;
 	if (yych == 'c') goto yy454;
 	goto yy358;
 yy461:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy392;
 	if (yych == 'e') goto yy392;
 	goto yy358;
 yy462:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5728,57 +6150,68 @@ yy462:
 		}
 	}
 yy463:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'K') goto yy488;
 	if (yych == 'k') goto yy488;
 	goto yy358;
 yy464:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy478;
 	if (yych == 'i') goto yy478;
 	goto yy358;
 yy465:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy489;
 	if (yych == 'e') goto yy489;
 	goto yy358;
 yy466:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy490;
 	if (yych == 'r') goto yy490;
 	goto yy358;
 yy467:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy491;
 	if (yych == 'i') goto yy491;
 	goto yy358;
 yy468:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy492;
 	if (yych == 'o') goto yy492;
 	goto yy358;
 yy469:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy493;
 	if (yych == 'd') goto yy493;
 	goto yy358;
 yy470:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy389;
 	if (yych == 'a') goto yy389;
 	goto yy358;
 yy471:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy461;
 	if (yych == 'r') goto yy461;
 	goto yy358;
 yy472:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy494;
 	if (yych == 'e') goto yy494;
 	goto yy358;
 yy473:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5800,17 +6233,20 @@ yy473:
 		}
 	}
 yy474:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy461;
 	if (yych == 'm') goto yy461;
 	goto yy358;
 yy475:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'N') goto yy484;
 	if (yych == 'n') goto yy484;
 	goto yy358;
 yy476:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5832,12 +6268,14 @@ yy476:
 		}
 	}
 yy477:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy496;
 	if (yych == 'a') goto yy496;
 	goto yy358;
 yy478:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy445;
 	if (yych == 'o') goto yy445;
 	goto yy358;
@@ -5845,72 +6283,86 @@ yy479:
 	++p;
 	{ return 1; }
 yy481:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'P') goto yy497;
 	if (yych == 'p') goto yy497;
 	goto yy358;
 yy482:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy498;
 	if (yych == 'a') goto yy498;
 	goto yy358;
 yy483:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy392;
 	if (yych == 't') goto yy392;
 	goto yy358;
 yy484:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'D') goto yy392;
 	if (yych == 'd') goto yy392;
 	goto yy358;
 yy485:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy499;
 	if (yych == 't') goto yy499;
 	goto yy358;
 yy486:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'S') goto yy500;
 	if (yych == 's') goto yy500;
 	goto yy358;
 yy487:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy501;
 	if (yych == 'o') goto yy501;
 	goto yy358;
 yy488:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'Q') goto yy502;
 	if (yych == 'q') goto yy502;
 	goto yy358;
 yy489:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy392;
 	if (yych == 'r') goto yy392;
 	goto yy358;
 yy490:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy503;
 	if (yych == 'o') goto yy503;
 	goto yy358;
 yy491:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy500;
 	if (yych == 'l') goto yy500;
 	goto yy358;
 yy492:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'G') goto yy392;
 	if (yych == 'g') goto yy392;
 	goto yy358;
 yy493:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'S') goto yy504;
 	if (yych == 's') goto yy504;
 	goto yy358;
 yy494:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy358;
@@ -5932,76 +6384,91 @@ yy494:
 		}
 	}
 yy495:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy505;
 	if (yych == 't') goto yy505;
 	goto yy358;
 yy496:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy506;
 	if (yych == 'm') goto yy506;
 	goto yy358;
 yy497:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy450;
 	if (yych == 't') goto yy450;
 	goto yy358;
 yy498:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy431;
 	if (yych == 'r') goto yy431;
 	goto yy358;
 yy499:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy507;
 	if (yych == 'a') goto yy507;
 	goto yy358;
 yy500:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'S') goto yy392;
 	if (yych == 's') goto yy392;
 	goto yy358;
 yy501:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'N') goto yy483;
 	if (yych == 'n') goto yy483;
 	goto yy358;
 yy502:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'U') goto yy508;
 	if (yych == 'u') goto yy508;
 	goto yy358;
 yy503:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'U') goto yy509;
 	if (yych == 'u') goto yy509;
 	goto yy358;
 yy504:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy483;
 	if (yych == 'e') goto yy483;
 	goto yy358;
 yy505:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy439;
 	if (yych == 'e') goto yy439;
 	goto yy358;
 yy506:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy500;
 	if (yych == 'e') goto yy500;
 	goto yy358;
 yy507:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == '[') goto yy510;
 	goto yy358;
 yy508:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'O') goto yy512;
 	if (yych == 'o') goto yy512;
 	goto yy358;
 yy509:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'P') goto yy392;
 	if (yych == 'p') goto yy392;
 	goto yy358;
@@ -6009,7 +6476,8 @@ yy510:
 	++p;
 	{ return 5; }
 yy512:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy461;
 	if (yych == 't') goto yy461;
 	goto yy358;
@@ -6019,7 +6487,7 @@ yy512:
 
 // Try to match an HTML block tag start line of type 7, returning
 // 7 if successful, 0 if not.
-bufsize_t _scan_html_block_start_7(const unsigned char *p)
+bufsize_t _scan_html_block_start_7(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
 
@@ -6060,14 +6528,16 @@ bufsize_t _scan_html_block_start_7(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '<') goto yy517;
 	++p;
 yy516:
 	{ return 0; }
 yy517:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych != '/') goto yy516;
 	} else {
@@ -6076,20 +6546,22 @@ yy517:
 		if (yych <= 'z') goto yy520;
 		goto yy516;
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '@') goto yy519;
 	if (yych <= 'Z') goto yy522;
 	if (yych <= '`') goto yy519;
 	if (yych <= 'z') goto yy522;
 yy519:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy516;
 	} else {
 		goto yy535;
 	}
 yy520:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 2) {
 		goto yy524;
 	}
@@ -6114,7 +6586,8 @@ yy520:
 		}
 	}
 yy522:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') {
 		if (yych <= 0x1F) {
 			if (yych <= 0x08) goto yy519;
@@ -6138,7 +6611,8 @@ yy522:
 		}
 	}
 yy524:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 2) {
 		goto yy524;
 	}
@@ -6162,10 +6636,12 @@ yy524:
 		}
 	}
 yy526:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych != '>') goto yy519;
 yy527:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 4) {
 		goto yy527;
 	}
@@ -6175,7 +6651,8 @@ yy527:
 	if (yych <= '\r') goto yy536;
 	goto yy519;
 yy529:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x1F) {
 		if (yych <= 0x08) goto yy519;
 		if (yych <= '\r') goto yy529;
@@ -6186,7 +6663,8 @@ yy529:
 		goto yy519;
 	}
 yy531:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 8) {
 		goto yy531;
 	}
@@ -6210,7 +6688,9 @@ yy531:
 	}
 yy533:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 4) {
 		goto yy527;
 	}
@@ -6224,7 +6704,8 @@ yy536:
 	++p;
 	goto yy535;
 yy537:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '<') {
 		if (yych <= ' ') {
 			if (yych <= 0x08) goto yy519;
@@ -6258,7 +6739,8 @@ yy537:
 		}
 	}
 yy539:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy541;
 	}
@@ -6285,7 +6767,8 @@ yy539:
 		}
 	}
 yy541:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy541;
 	}
@@ -6312,7 +6795,8 @@ yy541:
 		}
 	}
 yy543:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy543;
 	}
@@ -6338,7 +6822,8 @@ yy543:
 		}
 	}
 yy545:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy545;
 	}
@@ -6364,42 +6849,50 @@ yy545:
 		}
 	}
 yy547:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy541;
 	goto yy519;
 yy548:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy519;
 	if (yych <= 0xBF) goto yy547;
 	goto yy519;
 yy549:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy547;
 	goto yy519;
 yy550:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0x9F) goto yy547;
 	goto yy519;
 yy551:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy519;
 	if (yych <= 0xBF) goto yy549;
 	goto yy519;
 yy552:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy549;
 	goto yy519;
 yy553:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0x8F) goto yy549;
 	goto yy519;
 yy554:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 2) {
 		goto yy524;
 	}
@@ -6407,72 +6900,86 @@ yy554:
 	if (yych == '>') goto yy527;
 	goto yy519;
 yy555:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy543;
 	goto yy519;
 yy556:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy519;
 	if (yych <= 0xBF) goto yy555;
 	goto yy519;
 yy557:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy555;
 	goto yy519;
 yy558:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0x9F) goto yy555;
 	goto yy519;
 yy559:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy519;
 	if (yych <= 0xBF) goto yy557;
 	goto yy519;
 yy560:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy557;
 	goto yy519;
 yy561:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0x8F) goto yy557;
 	goto yy519;
 yy562:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy545;
 	goto yy519;
 yy563:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy519;
 	if (yych <= 0xBF) goto yy562;
 	goto yy519;
 yy564:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy562;
 	goto yy519;
 yy565:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0x9F) goto yy562;
 	goto yy519;
 yy566:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy519;
 	if (yych <= 0xBF) goto yy564;
 	goto yy519;
 yy567:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0xBF) goto yy564;
 	goto yy519;
 yy568:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy519;
 	if (yych <= 0x8F) goto yy564;
 	goto yy519;
@@ -6481,7 +6988,7 @@ yy568:
 }
 
 // Try to match an HTML block end line of type 1
-bufsize_t _scan_html_block_end_1(const unsigned char *p)
+bufsize_t _scan_html_block_end_1(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -6523,7 +7030,7 @@ bufsize_t _scan_html_block_end_1(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= 0xDF) {
 		if (yych <= ';') {
 			if (yych <= 0x00) goto yy571;
@@ -6550,7 +7057,9 @@ yy572:
 	{ return 0; }
 yy573:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '\n') {
 		if (yych <= 0x00) goto yy572;
 		if (yych <= '\t') goto yy583;
@@ -6563,7 +7072,9 @@ yy573:
 	}
 yy574:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '.') {
 		if (yych <= 0x00) goto yy572;
 		if (yych == '\n') goto yy572;
@@ -6580,48 +7091,63 @@ yy574:
 	}
 yy575:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy572;
 	if (yych <= 0xBF) goto yy582;
 	goto yy572;
 yy576:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy572;
 	if (yych <= 0xBF) goto yy587;
 	goto yy572;
 yy577:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy572;
 	if (yych <= 0xBF) goto yy587;
 	goto yy572;
 yy578:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy572;
 	if (yych <= 0x9F) goto yy587;
 	goto yy572;
 yy579:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy572;
 	if (yych <= 0xBF) goto yy589;
 	goto yy572;
 yy580:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy572;
 	if (yych <= 0xBF) goto yy589;
 	goto yy572;
 yy581:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy572;
 	if (yych <= 0x8F) goto yy589;
 	goto yy572;
 yy582:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy583:
 	if (yybm[0+yych] & 64) {
 		goto yy582;
@@ -6646,14 +7172,15 @@ yy583:
 		}
 	}
 yy584:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy572;
 	} else {
 		goto yy604;
 	}
 yy585:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6680,42 +7207,50 @@ yy585:
 		}
 	}
 yy587:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy584;
 	if (yych <= 0xBF) goto yy582;
 	goto yy584;
 yy588:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy584;
 	if (yych <= 0xBF) goto yy587;
 	goto yy584;
 yy589:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy584;
 	if (yych <= 0xBF) goto yy587;
 	goto yy584;
 yy590:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy584;
 	if (yych <= 0x9F) goto yy587;
 	goto yy584;
 yy591:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy584;
 	if (yych <= 0xBF) goto yy589;
 	goto yy584;
 yy592:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy584;
 	if (yych <= 0xBF) goto yy589;
 	goto yy584;
 yy593:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy584;
 	if (yych <= 0x8F) goto yy589;
 	goto yy584;
 yy594:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6761,7 +7296,8 @@ yy594:
 		}
 	}
 yy595:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6798,7 +7334,8 @@ yy595:
 		}
 	}
 yy596:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6845,7 +7382,8 @@ yy596:
 		}
 	}
 yy597:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6882,7 +7420,8 @@ yy597:
 		}
 	}
 yy598:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6919,7 +7458,8 @@ yy598:
 		}
 	}
 yy599:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6956,7 +7496,8 @@ yy599:
 		}
 	}
 yy600:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -6984,7 +7525,8 @@ yy600:
 		}
 	}
 yy601:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -7021,7 +7563,8 @@ yy601:
 		}
 	}
 yy602:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -7059,7 +7602,9 @@ yy602:
 	}
 yy603:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy582;
 	}
@@ -7085,7 +7630,8 @@ yy603:
 yy604:
 	{ return (bufsize_t)(p - start); }
 yy605:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -7121,7 +7667,8 @@ yy605:
 		}
 	}
 yy606:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy585;
 	}
@@ -7162,7 +7709,7 @@ yy606:
 }
 
 // Try to match an HTML block end line of type 2
-bufsize_t _scan_html_block_end_2(const unsigned char *p)
+bufsize_t _scan_html_block_end_2(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -7204,7 +7751,7 @@ bufsize_t _scan_html_block_end_2(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= 0xDF) {
 		if (yych <= ',') {
 			if (yych <= 0x00) goto yy609;
@@ -7231,7 +7778,9 @@ yy610:
 	{ return 0; }
 yy611:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '\n') {
 		if (yych <= 0x00) goto yy610;
 		if (yych <= '\t') goto yy621;
@@ -7244,7 +7793,9 @@ yy611:
 	}
 yy612:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy631;
 	}
@@ -7260,48 +7811,63 @@ yy612:
 	}
 yy613:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy610;
 	if (yych <= 0xBF) goto yy620;
 	goto yy610;
 yy614:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy610;
 	if (yych <= 0xBF) goto yy624;
 	goto yy610;
 yy615:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy610;
 	if (yych <= 0xBF) goto yy624;
 	goto yy610;
 yy616:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy610;
 	if (yych <= 0x9F) goto yy624;
 	goto yy610;
 yy617:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy610;
 	if (yych <= 0xBF) goto yy626;
 	goto yy610;
 yy618:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy610;
 	if (yych <= 0xBF) goto yy626;
 	goto yy610;
 yy619:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy610;
 	if (yych <= 0x8F) goto yy626;
 	goto yy610;
 yy620:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy621:
 	if (yybm[0+yych] & 64) {
 		goto yy620;
@@ -7326,14 +7892,15 @@ yy621:
 		}
 	}
 yy622:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy610;
 	} else {
 		goto yy634;
 	}
 yy623:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy620;
 	}
@@ -7359,42 +7926,50 @@ yy623:
 		}
 	}
 yy624:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy622;
 	if (yych <= 0xBF) goto yy620;
 	goto yy622;
 yy625:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy622;
 	if (yych <= 0xBF) goto yy624;
 	goto yy622;
 yy626:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy622;
 	if (yych <= 0xBF) goto yy624;
 	goto yy622;
 yy627:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy622;
 	if (yych <= 0x9F) goto yy624;
 	goto yy622;
 yy628:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy622;
 	if (yych <= 0xBF) goto yy626;
 	goto yy622;
 yy629:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy622;
 	if (yych <= 0xBF) goto yy626;
 	goto yy622;
 yy630:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy622;
 	if (yych <= 0x8F) goto yy626;
 	goto yy622;
 yy631:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy631;
 	}
@@ -7423,7 +7998,9 @@ yy631:
 	}
 yy633:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy620;
 	}
@@ -7453,7 +8030,7 @@ yy634:
 }
 
 // Try to match an HTML block end line of type 3
-bufsize_t _scan_html_block_end_3(const unsigned char *p)
+bufsize_t _scan_html_block_end_3(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -7495,7 +8072,7 @@ bufsize_t _scan_html_block_end_3(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= 0xDF) {
 		if (yych <= '>') {
 			if (yych <= 0x00) goto yy637;
@@ -7522,7 +8099,9 @@ yy638:
 	{ return 0; }
 yy639:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '\n') {
 		if (yych <= 0x00) goto yy638;
 		if (yych <= '\t') goto yy649;
@@ -7535,7 +8114,9 @@ yy639:
 	}
 yy640:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '=') {
 		if (yych <= 0x00) goto yy638;
 		if (yych == '\n') goto yy638;
@@ -7552,48 +8133,63 @@ yy640:
 	}
 yy641:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy638;
 	if (yych <= 0xBF) goto yy648;
 	goto yy638;
 yy642:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy638;
 	if (yych <= 0xBF) goto yy653;
 	goto yy638;
 yy643:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy638;
 	if (yych <= 0xBF) goto yy653;
 	goto yy638;
 yy644:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy638;
 	if (yych <= 0x9F) goto yy653;
 	goto yy638;
 yy645:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy638;
 	if (yych <= 0xBF) goto yy655;
 	goto yy638;
 yy646:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy638;
 	if (yych <= 0xBF) goto yy655;
 	goto yy638;
 yy647:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy638;
 	if (yych <= 0x8F) goto yy655;
 	goto yy638;
 yy648:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy649:
 	if (yybm[0+yych] & 64) {
 		goto yy648;
@@ -7618,14 +8214,15 @@ yy649:
 		}
 	}
 yy650:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy638;
 	} else {
 		goto yy661;
 	}
 yy651:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy651;
 	}
@@ -7652,43 +8249,52 @@ yy651:
 		}
 	}
 yy653:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy650;
 	if (yych <= 0xBF) goto yy648;
 	goto yy650;
 yy654:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy650;
 	if (yych <= 0xBF) goto yy653;
 	goto yy650;
 yy655:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy650;
 	if (yych <= 0xBF) goto yy653;
 	goto yy650;
 yy656:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy650;
 	if (yych <= 0x9F) goto yy653;
 	goto yy650;
 yy657:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy650;
 	if (yych <= 0xBF) goto yy655;
 	goto yy650;
 yy658:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy650;
 	if (yych <= 0xBF) goto yy655;
 	goto yy650;
 yy659:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy650;
 	if (yych <= 0x8F) goto yy655;
 	goto yy650;
 yy660:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy648;
 	}
@@ -7718,7 +8324,7 @@ yy661:
 }
 
 // Try to match an HTML block end line of type 4
-bufsize_t _scan_html_block_end_4(const unsigned char *p)
+bufsize_t _scan_html_block_end_4(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -7760,7 +8366,7 @@ bufsize_t _scan_html_block_end_4(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy667;
 	}
@@ -7790,7 +8396,9 @@ yy665:
 	{ return 0; }
 yy666:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '\n') {
 		if (yych <= 0x00) goto yy665;
 		if (yych <= '\t') goto yy678;
@@ -7803,7 +8411,9 @@ yy666:
 	}
 yy667:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy677;
 	}
@@ -7830,48 +8440,63 @@ yy669:
 	{ return (bufsize_t)(p - start); }
 yy670:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy665;
 	if (yych <= 0xBF) goto yy677;
 	goto yy665;
 yy671:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy665;
 	if (yych <= 0xBF) goto yy680;
 	goto yy665;
 yy672:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy665;
 	if (yych <= 0xBF) goto yy680;
 	goto yy665;
 yy673:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy665;
 	if (yych <= 0x9F) goto yy680;
 	goto yy665;
 yy674:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy665;
 	if (yych <= 0xBF) goto yy682;
 	goto yy665;
 yy675:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy665;
 	if (yych <= 0xBF) goto yy682;
 	goto yy665;
 yy676:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy665;
 	if (yych <= 0x8F) goto yy682;
 	goto yy665;
 yy677:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy678:
 	if (yybm[0+yych] & 128) {
 		goto yy677;
@@ -7896,44 +8521,51 @@ yy678:
 		}
 	}
 yy679:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy665;
 	} else {
 		goto yy669;
 	}
 yy680:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy679;
 	if (yych <= 0xBF) goto yy677;
 	goto yy679;
 yy681:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy679;
 	if (yych <= 0xBF) goto yy680;
 	goto yy679;
 yy682:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy679;
 	if (yych <= 0xBF) goto yy680;
 	goto yy679;
 yy683:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy679;
 	if (yych <= 0x9F) goto yy680;
 	goto yy679;
 yy684:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy679;
 	if (yych <= 0xBF) goto yy682;
 	goto yy679;
 yy685:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy679;
 	if (yych <= 0xBF) goto yy682;
 	goto yy679;
 yy686:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy679;
 	if (yych <= 0x8F) goto yy682;
 	goto yy679;
@@ -7942,7 +8574,7 @@ yy686:
 }
 
 // Try to match an HTML block end line of type 5
-bufsize_t _scan_html_block_end_5(const unsigned char *p)
+bufsize_t _scan_html_block_end_5(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -7984,7 +8616,7 @@ bufsize_t _scan_html_block_end_5(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= 0xDF) {
 		if (yych <= '\\') {
 			if (yych <= 0x00) goto yy689;
@@ -8011,7 +8643,9 @@ yy690:
 	{ return 0; }
 yy691:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '\n') {
 		if (yych <= 0x00) goto yy690;
 		if (yych <= '\t') goto yy701;
@@ -8024,7 +8658,9 @@ yy691:
 	}
 yy692:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy711;
 	}
@@ -8040,48 +8676,63 @@ yy692:
 	}
 yy693:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy690;
 	if (yych <= 0xBF) goto yy700;
 	goto yy690;
 yy694:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy690;
 	if (yych <= 0xBF) goto yy704;
 	goto yy690;
 yy695:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy690;
 	if (yych <= 0xBF) goto yy704;
 	goto yy690;
 yy696:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy690;
 	if (yych <= 0x9F) goto yy704;
 	goto yy690;
 yy697:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy690;
 	if (yych <= 0xBF) goto yy706;
 	goto yy690;
 yy698:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy690;
 	if (yych <= 0xBF) goto yy706;
 	goto yy690;
 yy699:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy690;
 	if (yych <= 0x8F) goto yy706;
 	goto yy690;
 yy700:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy701:
 	if (yybm[0+yych] & 64) {
 		goto yy700;
@@ -8106,14 +8757,15 @@ yy701:
 		}
 	}
 yy702:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy690;
 	} else {
 		goto yy714;
 	}
 yy703:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy700;
 	}
@@ -8139,42 +8791,50 @@ yy703:
 		}
 	}
 yy704:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy702;
 	if (yych <= 0xBF) goto yy700;
 	goto yy702;
 yy705:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy702;
 	if (yych <= 0xBF) goto yy704;
 	goto yy702;
 yy706:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy702;
 	if (yych <= 0xBF) goto yy704;
 	goto yy702;
 yy707:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy702;
 	if (yych <= 0x9F) goto yy704;
 	goto yy702;
 yy708:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy702;
 	if (yych <= 0xBF) goto yy706;
 	goto yy702;
 yy709:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy702;
 	if (yych <= 0xBF) goto yy706;
 	goto yy702;
 yy710:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy702;
 	if (yych <= 0x8F) goto yy706;
 	goto yy702;
 yy711:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy711;
 	}
@@ -8203,7 +8863,9 @@ yy711:
 	}
 yy713:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy700;
 	}
@@ -8235,7 +8897,7 @@ yy714:
 // Try to match a link title (in single quotes, in double quotes, or
 // in parentheses), returning number of chars matched.  Allow one
 // level of internal nesting (quotes within quotes).
-bufsize_t _scan_link_title(const unsigned char *p)
+bufsize_t _scan_link_title(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -8277,7 +8939,7 @@ bufsize_t _scan_link_title(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= '&') {
 		if (yych == '"') goto yy719;
 	} else {
@@ -8289,7 +8951,9 @@ yy718:
 	{ return 0; }
 yy719:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x00) goto yy718;
 	if (yych <= 0x7F) goto yy723;
 	if (yych <= 0xC1) goto yy718;
@@ -8297,7 +8961,9 @@ yy719:
 	goto yy718;
 yy720:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= 0x00) goto yy718;
 	if (yych <= 0x7F) goto yy737;
 	if (yych <= 0xC1) goto yy718;
@@ -8305,7 +8971,9 @@ yy720:
 	goto yy718;
 yy721:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '(') {
 		if (yych <= 0x00) goto yy718;
 		if (yych <= '\'') goto yy750;
@@ -8317,7 +8985,8 @@ yy721:
 		goto yy718;
 	}
 yy722:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy723:
 	if (yybm[0+yych] & 16) {
 		goto yy722;
@@ -8343,7 +9012,7 @@ yy723:
 		}
 	}
 yy724:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept <= 1) {
 		if (yyaccept == 0) {
 			goto yy718;
@@ -8362,7 +9031,8 @@ yy725:
 yy726:
 	{ return (bufsize_t)(p - start); }
 yy727:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 16) {
 		goto yy722;
 	}
@@ -8387,42 +9057,50 @@ yy727:
 		}
 	}
 yy729:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy722;
 	goto yy724;
 yy730:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy724;
 	if (yych <= 0xBF) goto yy729;
 	goto yy724;
 yy731:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy729;
 	goto yy724;
 yy732:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0x9F) goto yy729;
 	goto yy724;
 yy733:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy724;
 	if (yych <= 0xBF) goto yy731;
 	goto yy724;
 yy734:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy731;
 	goto yy724;
 yy735:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0x8F) goto yy731;
 	goto yy724;
 yy736:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy737:
 	if (yybm[0+yych] & 64) {
 		goto yy736;
@@ -8452,7 +9130,8 @@ yy738:
 yy739:
 	{ return (bufsize_t)(p - start); }
 yy740:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy736;
 	}
@@ -8477,42 +9156,50 @@ yy740:
 		}
 	}
 yy742:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy736;
 	goto yy724;
 yy743:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy724;
 	if (yych <= 0xBF) goto yy742;
 	goto yy724;
 yy744:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy742;
 	goto yy724;
 yy745:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0x9F) goto yy742;
 	goto yy724;
 yy746:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy724;
 	if (yych <= 0xBF) goto yy744;
 	goto yy724;
 yy747:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy744;
 	goto yy724;
 yy748:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0x8F) goto yy744;
 	goto yy724;
 yy749:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy750:
 	if (yybm[0+yych] & 128) {
 		goto yy749;
@@ -8542,7 +9229,8 @@ yy751:
 yy752:
 	{ return (bufsize_t)(p - start); }
 yy753:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0xDF) {
 		if (yych <= '[') {
 			if (yych <= 0x00) goto yy724;
@@ -8566,43 +9254,52 @@ yy753:
 		}
 	}
 yy755:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy749;
 	goto yy724;
 yy756:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy724;
 	if (yych <= 0xBF) goto yy755;
 	goto yy724;
 yy757:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy755;
 	goto yy724;
 yy758:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0x9F) goto yy755;
 	goto yy724;
 yy759:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy724;
 	if (yych <= 0xBF) goto yy757;
 	goto yy724;
 yy760:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0xBF) goto yy757;
 	goto yy724;
 yy761:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy724;
 	if (yych <= 0x8F) goto yy757;
 	goto yy724;
 yy762:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 16) {
 		goto yy722;
 	}
@@ -8629,7 +9326,9 @@ yy762:
 	}
 yy763:
 	yyaccept = 2;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy736;
 	}
@@ -8656,7 +9355,9 @@ yy763:
 	}
 yy764:
 	yyaccept = 3;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy749;
 	}
@@ -8686,7 +9387,7 @@ yy764:
 }
 
 // Match space characters, including newlines.
-bufsize_t _scan_spacechars(const unsigned char *p)
+bufsize_t _scan_spacechars(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *start = p; \
 
@@ -8726,14 +9427,15 @@ bufsize_t _scan_spacechars(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy769;
 	}
 	++p;
 	{ return 0; }
 yy769:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy769;
 	}
@@ -8743,7 +9445,7 @@ yy769:
 }
 
 // Match ATX heading start.
-bufsize_t _scan_atx_heading_start(const unsigned char *p)
+bufsize_t _scan_atx_heading_start(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -8784,13 +9486,15 @@ bufsize_t _scan_atx_heading_start(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '#') goto yy776;
 	++p;
 yy775:
 	{ return 0; }
 yy776:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8804,7 +9508,8 @@ yy776:
 		goto yy775;
 	}
 yy777:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8814,7 +9519,8 @@ yy780:
 	++p;
 	goto yy779;
 yy781:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8826,10 +9532,11 @@ yy781:
 		if (yych == '#') goto yy783;
 	}
 yy782:
-	p = marker;
+	YYRESTORE ();
 	goto yy775;
 yy783:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8841,7 +9548,8 @@ yy783:
 		if (yych <= '\r') goto yy780;
 		if (yych != '#') goto yy782;
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8853,7 +9561,8 @@ yy783:
 		if (yych <= '\r') goto yy780;
 		if (yych != '#') goto yy782;
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8865,7 +9574,8 @@ yy783:
 		if (yych <= '\r') goto yy780;
 		if (yych != '#') goto yy782;
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy777;
 	}
@@ -8879,7 +9589,7 @@ yy783:
 
 // Match setext heading line.  Return 1 for level-1 heading,
 // 2 for level-2, 0 for no match.
-bufsize_t _scan_setext_heading_line(const unsigned char *p)
+bufsize_t _scan_setext_heading_line(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
 
@@ -8919,14 +9629,16 @@ bufsize_t _scan_setext_heading_line(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '-') goto yy791;
 	if (yych == '=') goto yy792;
 	++p;
 yy790:
 	{ return 0; }
 yy791:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy798;
 	}
@@ -8940,7 +9652,9 @@ yy791:
 		goto yy790;
 	}
 yy792:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy804;
 	}
@@ -8954,7 +9668,8 @@ yy792:
 		goto yy790;
 	}
 yy793:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy794:
 	if (yybm[0+yych] & 32) {
 		goto yy793;
@@ -8963,13 +9678,14 @@ yy794:
 	if (yych <= '\n') goto yy796;
 	if (yych == '\r') goto yy796;
 yy795:
-	p = marker;
+	YYRESTORE ();
 	goto yy790;
 yy796:
 	++p;
 	{ return 2; }
 yy798:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy793;
 	}
@@ -8983,7 +9699,8 @@ yy798:
 		goto yy795;
 	}
 yy800:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy801:
 	if (yych <= '\f') {
 		if (yych <= 0x08) goto yy795;
@@ -8998,7 +9715,8 @@ yy802:
 	++p;
 	{ return 1; }
 yy804:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy804;
 	}
@@ -9017,7 +9735,7 @@ yy804:
 }
 
 // Scan an opening code fence.
-bufsize_t _scan_open_code_fence(const unsigned char *p)
+bufsize_t _scan_open_code_fence(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -9058,36 +9776,43 @@ bufsize_t _scan_open_code_fence(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '`') goto yy810;
 	if (yych == '~') goto yy811;
 	++p;
 yy809:
 	{ return 0; }
 yy810:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == '`') goto yy812;
 	goto yy809;
 yy811:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == '~') goto yy814;
 	goto yy809;
 yy812:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 16) {
 		goto yy815;
 	}
 yy813:
-	p = marker;
+	YYRESTORE ();
 	goto yy809;
 yy814:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy817;
 	}
 	goto yy813;
 yy815:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 16) {
 		goto yy815;
 	}
@@ -9095,54 +9820,55 @@ yy815:
 		if (yych <= '\f') {
 			if (yych <= 0x00) goto yy813;
 			if (yych == '\n') {
-				marker = p;
+				YYBACKUP ();
 				goto yy821;
 			}
-			marker = p;
+			YYBACKUP ();
 			goto yy819;
 		} else {
 			if (yych <= '\r') {
-				marker = p;
+				YYBACKUP ();
 				goto yy821;
 			}
 			if (yych <= 0x7F) {
-				marker = p;
+				YYBACKUP ();
 				goto yy819;
 			}
 			if (yych <= 0xC1) goto yy813;
-			marker = p;
+			YYBACKUP ();
 			goto yy823;
 		}
 	} else {
 		if (yych <= 0xEF) {
 			if (yych <= 0xE0) {
-				marker = p;
+				YYBACKUP ();
 				goto yy824;
 			}
 			if (yych == 0xED) {
-				marker = p;
+				YYBACKUP ();
 				goto yy826;
 			}
-			marker = p;
+			YYBACKUP ();
 			goto yy825;
 		} else {
 			if (yych <= 0xF0) {
-				marker = p;
+				YYBACKUP ();
 				goto yy827;
 			}
 			if (yych <= 0xF3) {
-				marker = p;
+				YYBACKUP ();
 				goto yy828;
 			}
 			if (yych <= 0xF4) {
-				marker = p;
+				YYBACKUP ();
 				goto yy829;
 			}
 			goto yy813;
 		}
 	}
 yy817:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy817;
 	}
@@ -9150,54 +9876,55 @@ yy817:
 		if (yych <= '\f') {
 			if (yych <= 0x00) goto yy813;
 			if (yych == '\n') {
-				marker = p;
+				YYBACKUP ();
 				goto yy832;
 			}
-			marker = p;
+			YYBACKUP ();
 			goto yy830;
 		} else {
 			if (yych <= '\r') {
-				marker = p;
+				YYBACKUP ();
 				goto yy832;
 			}
 			if (yych <= 0x7F) {
-				marker = p;
+				YYBACKUP ();
 				goto yy830;
 			}
 			if (yych <= 0xC1) goto yy813;
-			marker = p;
+			YYBACKUP ();
 			goto yy834;
 		}
 	} else {
 		if (yych <= 0xEF) {
 			if (yych <= 0xE0) {
-				marker = p;
+				YYBACKUP ();
 				goto yy835;
 			}
 			if (yych == 0xED) {
-				marker = p;
+				YYBACKUP ();
 				goto yy837;
 			}
-			marker = p;
+			YYBACKUP ();
 			goto yy836;
 		} else {
 			if (yych <= 0xF0) {
-				marker = p;
+				YYBACKUP ();
 				goto yy838;
 			}
 			if (yych <= 0xF3) {
-				marker = p;
+				YYBACKUP ();
 				goto yy839;
 			}
 			if (yych <= 0xF4) {
-				marker = p;
+				YYBACKUP ();
 				goto yy840;
 			}
 			goto yy813;
 		}
 	}
 yy819:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy819;
 	}
@@ -9223,45 +9950,53 @@ yy819:
 	}
 yy821:
 	++p;
-	p = marker;
+	YYRESTORE ();
 	{ return (bufsize_t)(p - start); }
 yy823:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0xBF) goto yy819;
 	goto yy813;
 yy824:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy813;
 	if (yych <= 0xBF) goto yy823;
 	goto yy813;
 yy825:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0xBF) goto yy823;
 	goto yy813;
 yy826:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0x9F) goto yy823;
 	goto yy813;
 yy827:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy813;
 	if (yych <= 0xBF) goto yy825;
 	goto yy813;
 yy828:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0xBF) goto yy825;
 	goto yy813;
 yy829:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0x8F) goto yy825;
 	goto yy813;
 yy830:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy830;
 	}
@@ -9287,40 +10022,47 @@ yy830:
 	}
 yy832:
 	++p;
-	p = marker;
+	YYRESTORE ();
 	{ return (bufsize_t)(p - start); }
 yy834:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0xBF) goto yy830;
 	goto yy813;
 yy835:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy813;
 	if (yych <= 0xBF) goto yy834;
 	goto yy813;
 yy836:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0xBF) goto yy834;
 	goto yy813;
 yy837:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0x9F) goto yy834;
 	goto yy813;
 yy838:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy813;
 	if (yych <= 0xBF) goto yy836;
 	goto yy813;
 yy839:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0xBF) goto yy836;
 	goto yy813;
 yy840:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy813;
 	if (yych <= 0x8F) goto yy836;
 	goto yy813;
@@ -9329,7 +10071,7 @@ yy840:
 }
 
 // Scan a closing code fence with length at least len.
-bufsize_t _scan_close_code_fence(const unsigned char *p)
+bufsize_t _scan_close_code_fence(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -9370,90 +10112,99 @@ bufsize_t _scan_close_code_fence(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '`') goto yy845;
 	if (yych == '~') goto yy846;
 	++p;
 yy844:
 	{ return 0; }
 yy845:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == '`') goto yy847;
 	goto yy844;
 yy846:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == '~') goto yy849;
 	goto yy844;
 yy847:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy850;
 	}
 yy848:
-	p = marker;
+	YYRESTORE ();
 	goto yy844;
 yy849:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy852;
 	}
 	goto yy848;
 yy850:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 32) {
 		goto yy850;
 	}
 	if (yych <= '\f') {
 		if (yych <= 0x08) goto yy848;
 		if (yych <= '\t') {
-			marker = p;
+			YYBACKUP ();
 			goto yy854;
 		}
 		if (yych <= '\n') {
-			marker = p;
+			YYBACKUP ();
 			goto yy856;
 		}
 		goto yy848;
 	} else {
 		if (yych <= '\r') {
-			marker = p;
+			YYBACKUP ();
 			goto yy856;
 		}
 		if (yych == ' ') {
-			marker = p;
+			YYBACKUP ();
 			goto yy854;
 		}
 		goto yy848;
 	}
 yy852:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 64) {
 		goto yy852;
 	}
 	if (yych <= '\f') {
 		if (yych <= 0x08) goto yy848;
 		if (yych <= '\t') {
-			marker = p;
+			YYBACKUP ();
 			goto yy858;
 		}
 		if (yych <= '\n') {
-			marker = p;
+			YYBACKUP ();
 			goto yy860;
 		}
 		goto yy848;
 	} else {
 		if (yych <= '\r') {
-			marker = p;
+			YYBACKUP ();
 			goto yy860;
 		}
 		if (yych == ' ') {
-			marker = p;
+			YYBACKUP ();
 			goto yy858;
 		}
 		goto yy848;
 	}
 yy854:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy854;
 	}
@@ -9462,10 +10213,11 @@ yy854:
 	if (yych != '\r') goto yy848;
 yy856:
 	++p;
-	p = marker;
+	YYRESTORE ();
 	{ return (bufsize_t)(p - start); }
 yy858:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '\f') {
 		if (yych <= 0x08) goto yy848;
 		if (yych <= '\t') goto yy858;
@@ -9477,7 +10229,7 @@ yy858:
 	}
 yy860:
 	++p;
-	p = marker;
+	YYRESTORE ();
 	{ return (bufsize_t)(p - start); }
 }
 
@@ -9485,20 +10237,22 @@ yy860:
 
 // Scans an entity.
 // Returns number of chars matched.
-bufsize_t _scan_entity(const unsigned char *p)
+bufsize_t _scan_entity(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
 
 {
 	unsigned char yych;
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '&') goto yy866;
 	++p;
 yy865:
 	{ return 0; }
 yy866:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych != '#') goto yy865;
 	} else {
@@ -9507,7 +10261,8 @@ yy866:
 		if (yych <= 'z') goto yy869;
 		goto yy865;
 	}
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'W') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy870;
@@ -9516,10 +10271,11 @@ yy866:
 		if (yych == 'x') goto yy871;
 	}
 yy868:
-	p = marker;
+	YYRESTORE ();
 	goto yy865;
 yy869:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy872;
@@ -9531,13 +10287,15 @@ yy869:
 		goto yy868;
 	}
 yy870:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') goto yy868;
 	if (yych <= '9') goto yy873;
 	if (yych == ';') goto yy874;
 	goto yy868;
 yy871:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '@') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy876;
@@ -9549,7 +10307,8 @@ yy871:
 		goto yy868;
 	}
 yy872:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy877;
@@ -9566,7 +10325,8 @@ yy872:
 		}
 	}
 yy873:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') goto yy868;
 	if (yych <= '9') goto yy878;
 	if (yych != ';') goto yy868;
@@ -9574,7 +10334,8 @@ yy874:
 	++p;
 	{ return (bufsize_t)(p - start); }
 yy876:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy879;
@@ -9591,7 +10352,8 @@ yy876:
 		}
 	}
 yy877:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy880;
@@ -9608,13 +10370,15 @@ yy877:
 		}
 	}
 yy878:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') goto yy868;
 	if (yych <= '9') goto yy881;
 	if (yych == ';') goto yy874;
 	goto yy868;
 yy879:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy882;
@@ -9631,7 +10395,8 @@ yy879:
 		}
 	}
 yy880:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy883;
@@ -9648,13 +10413,15 @@ yy880:
 		}
 	}
 yy881:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') goto yy868;
 	if (yych <= '9') goto yy884;
 	if (yych == ';') goto yy874;
 	goto yy868;
 yy882:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy885;
@@ -9671,7 +10438,8 @@ yy882:
 		}
 	}
 yy883:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy886;
@@ -9688,13 +10456,15 @@ yy883:
 		}
 	}
 yy884:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') goto yy868;
 	if (yych <= '9') goto yy887;
 	if (yych == ';') goto yy874;
 	goto yy868;
 yy885:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy888;
@@ -9711,7 +10481,8 @@ yy885:
 		}
 	}
 yy886:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy889;
@@ -9728,13 +10499,15 @@ yy886:
 		}
 	}
 yy887:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= '/') goto yy868;
 	if (yych <= '9') goto yy890;
 	if (yych == ';') goto yy874;
 	goto yy868;
 yy888:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy890;
@@ -9751,7 +10524,8 @@ yy888:
 		}
 	}
 yy889:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy891;
@@ -9768,11 +10542,13 @@ yy889:
 		}
 	}
 yy890:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == ';') goto yy874;
 	goto yy868;
 yy891:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy892;
@@ -9787,7 +10563,8 @@ yy891:
 		}
 	}
 yy892:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy893;
@@ -9802,7 +10579,8 @@ yy892:
 		}
 	}
 yy893:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy894;
@@ -9817,7 +10595,8 @@ yy893:
 		}
 	}
 yy894:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy895;
@@ -9832,7 +10611,8 @@ yy894:
 		}
 	}
 yy895:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy896;
@@ -9847,7 +10627,8 @@ yy895:
 		}
 	}
 yy896:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy897;
@@ -9862,7 +10643,8 @@ yy896:
 		}
 	}
 yy897:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy898;
@@ -9877,7 +10659,8 @@ yy897:
 		}
 	}
 yy898:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy899;
@@ -9892,7 +10675,8 @@ yy898:
 		}
 	}
 yy899:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy900;
@@ -9907,7 +10691,8 @@ yy899:
 		}
 	}
 yy900:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy901;
@@ -9922,7 +10707,8 @@ yy900:
 		}
 	}
 yy901:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy902;
@@ -9937,7 +10723,8 @@ yy901:
 		}
 	}
 yy902:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy903;
@@ -9952,7 +10739,8 @@ yy902:
 		}
 	}
 yy903:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy904;
@@ -9967,7 +10755,8 @@ yy903:
 		}
 	}
 yy904:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy905;
@@ -9982,7 +10771,8 @@ yy904:
 		}
 	}
 yy905:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy906;
@@ -9997,7 +10787,8 @@ yy905:
 		}
 	}
 yy906:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy907;
@@ -10012,7 +10803,8 @@ yy906:
 		}
 	}
 yy907:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy908;
@@ -10027,7 +10819,8 @@ yy907:
 		}
 	}
 yy908:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy909;
@@ -10042,7 +10835,8 @@ yy908:
 		}
 	}
 yy909:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy910;
@@ -10057,7 +10851,8 @@ yy909:
 		}
 	}
 yy910:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy911;
@@ -10072,7 +10867,8 @@ yy910:
 		}
 	}
 yy911:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy912;
@@ -10087,7 +10883,8 @@ yy911:
 		}
 	}
 yy912:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy913;
@@ -10102,7 +10899,8 @@ yy912:
 		}
 	}
 yy913:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy914;
@@ -10117,7 +10915,8 @@ yy913:
 		}
 	}
 yy914:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= ';') {
 		if (yych <= '/') goto yy868;
 		if (yych <= '9') goto yy890;
@@ -10139,7 +10938,7 @@ yy914:
 
 // Returns positive value if a URL begins in a way that is potentially
 // dangerous, with javascript:, vbscript:, file:, or data:, otherwise 0.
-bufsize_t _scan_dangerous_url(const unsigned char *p)
+bufsize_t _scan_dangerous_url(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -10147,7 +10946,7 @@ bufsize_t _scan_dangerous_url(const unsigned char *p)
 {
 	unsigned char yych;
 	unsigned int yyaccept = 0;
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych <= 'V') {
 		if (yych <= 'F') {
 			if (yych == 'D') goto yy919;
@@ -10173,90 +10972,111 @@ yy918:
 	{ return 0; }
 yy919:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy923;
 	if (yych == 'a') goto yy923;
 	goto yy918;
 yy920:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy925;
 	if (yych == 'i') goto yy925;
 	goto yy918;
 yy921:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy926;
 	if (yych == 'a') goto yy926;
 	goto yy918;
 yy922:
 	yyaccept = 0;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == 'B') goto yy927;
 	if (yych == 'b') goto yy927;
 	goto yy918;
 yy923:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy928;
 	if (yych == 't') goto yy928;
 yy924:
-	p = marker;
+	YYRESTORE ();
 	if (yyaccept == 0) {
 		goto yy918;
 	} else {
 		goto yy936;
 	}
 yy925:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'L') goto yy929;
 	if (yych == 'l') goto yy929;
 	goto yy924;
 yy926:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'V') goto yy930;
 	if (yych == 'v') goto yy930;
 	goto yy924;
 yy927:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'S') goto yy931;
 	if (yych == 's') goto yy931;
 	goto yy924;
 yy928:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy932;
 	if (yych == 'a') goto yy932;
 	goto yy924;
 yy929:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy933;
 	if (yych == 'e') goto yy933;
 	goto yy924;
 yy930:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy927;
 	if (yych == 'a') goto yy927;
 	goto yy924;
 yy931:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'C') goto yy934;
 	if (yych == 'c') goto yy934;
 	goto yy924;
 yy932:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == ':') goto yy935;
 	goto yy924;
 yy933:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == ':') goto yy937;
 	goto yy924;
 yy934:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'R') goto yy938;
 	if (yych == 'r') goto yy938;
 	goto yy924;
 yy935:
 	yyaccept = 1;
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy939;
 	if (yych == 'i') goto yy939;
 yy936:
@@ -10265,42 +11085,51 @@ yy937:
 	++p;
 	goto yy936;
 yy938:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy940;
 	if (yych == 'i') goto yy940;
 	goto yy924;
 yy939:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'M') goto yy941;
 	if (yych == 'm') goto yy941;
 	goto yy924;
 yy940:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'P') goto yy942;
 	if (yych == 'p') goto yy942;
 	goto yy924;
 yy941:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'A') goto yy943;
 	if (yych == 'a') goto yy943;
 	goto yy924;
 yy942:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'T') goto yy933;
 	if (yych == 't') goto yy933;
 	goto yy924;
 yy943:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'G') goto yy944;
 	if (yych != 'g') goto yy924;
 yy944:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy945;
 	if (yych != 'e') goto yy924;
 yy945:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych != '/') goto yy924;
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 'W') {
 		if (yych <= 'J') {
 			if (yych == 'G') goto yy947;
@@ -10327,41 +11156,49 @@ yy945:
 		}
 	}
 yy947:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'I') goto yy951;
 	if (yych == 'i') goto yy951;
 	goto yy924;
 yy948:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'P') goto yy952;
 	if (yych == 'p') goto yy952;
 	goto yy924;
 yy949:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'N') goto yy953;
 	if (yych == 'n') goto yy953;
 	goto yy924;
 yy950:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy954;
 	if (yych == 'e') goto yy954;
 	goto yy924;
 yy951:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'F') goto yy955;
 	if (yych == 'f') goto yy955;
 	goto yy924;
 yy952:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'E') goto yy953;
 	if (yych != 'e') goto yy924;
 yy953:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'G') goto yy955;
 	if (yych == 'g') goto yy955;
 	goto yy924;
 yy954:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'B') goto yy957;
 	if (yych == 'b') goto yy957;
 	goto yy924;
@@ -10369,7 +11206,8 @@ yy955:
 	++p;
 	{ return 0; }
 yy957:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych == 'P') goto yy955;
 	if (yych == 'p') goto yy955;
 	goto yy924;
@@ -10378,7 +11216,7 @@ yy957:
 }
 
 // Scans a footnote definition opening.
-bufsize_t _scan_footnote_definition(const unsigned char *p)
+bufsize_t _scan_footnote_definition(const unsigned char *p, const unsigned char *end)
 {
   const unsigned char *marker = NULL;
   const unsigned char *start = p;
@@ -10419,21 +11257,25 @@ bufsize_t _scan_footnote_definition(const unsigned char *p)
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 		  0,   0,   0,   0,   0,   0,   0,   0, 
 	};
-	yych = *p;
+	yych = YYPEEK ();
 	if (yych == '[') goto yy962;
 	++p;
 yy961:
 	{ return 0; }
 yy962:
-	yych = *(marker = ++p);
+	YYSKIP ();
+	YYBACKUP ();
+	yych = YYPEEK ();
 	if (yych != '^') goto yy961;
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych != ']') goto yy966;
 yy964:
-	p = marker;
+	YYRESTORE ();
 	goto yy961;
 yy965:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 yy966:
 	if (yybm[0+yych] & 64) {
 		goto yy965;
@@ -10460,45 +11302,54 @@ yy966:
 		}
 	}
 yy967:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy964;
 	if (yych <= 0xBF) goto yy965;
 	goto yy964;
 yy968:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x9F) goto yy964;
 	if (yych <= 0xBF) goto yy967;
 	goto yy964;
 yy969:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy964;
 	if (yych <= 0xBF) goto yy967;
 	goto yy964;
 yy970:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy964;
 	if (yych <= 0x9F) goto yy967;
 	goto yy964;
 yy971:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x8F) goto yy964;
 	if (yych <= 0xBF) goto yy969;
 	goto yy964;
 yy972:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy964;
 	if (yych <= 0xBF) goto yy969;
 	goto yy964;
 yy973:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych <= 0x7F) goto yy964;
 	if (yych <= 0x8F) goto yy969;
 	goto yy964;
 yy974:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yych != ':') goto yy964;
 yy975:
-	yych = *++p;
+	YYSKIP ();
+	yych = YYPEEK ();
 	if (yybm[0+yych] & 128) {
 		goto yy975;
 	}
@@ -1,6 +1,7 @@
 #include "strikethrough.h"
 #include <parser.h>
 #include <render.h>
+#include <html.h>
 
 cmark_node_type CMARK_NODE_STRIKETHROUGH;
 
@@ -129,7 +130,9 @@ static void html_render(cmark_syntax_extension *extension,
                         cmark_event_type ev_type, int options) {
   bool entering = (ev_type == CMARK_EVENT_ENTER);
   if (entering) {
-    cmark_strbuf_puts(renderer->html, "<del>");
+    cmark_strbuf_puts(renderer->html, "<del");
+    cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_STRIKETHROUGH);
+    cmark_strbuf_putc(renderer->html, '>');
   } else {
     cmark_strbuf_puts(renderer->html, "</del>");
   }
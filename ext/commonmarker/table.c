@@ -684,6 +684,7 @@ static void html_render(cmark_syntax_extension *extension,
       cmark_html_render_cr(html);
       cmark_strbuf_puts(html, "<table");
       cmark_html_render_sourcepos(node, html, options);
+      cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_TABLE);
       cmark_strbuf_putc(html, '>');
       table_state->need_closing_table_body = false;
     } else {
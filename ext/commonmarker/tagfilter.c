@@ -2,7 +2,7 @@
 #include <parser.h>
 #include <ctype.h>
 
-static const char *blacklist[] = {
+static const char *const blacklist[] = {
     "title",   "textarea", "style",  "xmp",       "iframe",
     "noembed", "noframes", "script", "plaintext", NULL,
 };
@@ -42,7 +42,7 @@ static int is_tag(const unsigned char *tag_data, size_t tag_size,
 
 static int filter(cmark_syntax_extension *ext, const unsigned char *tag,
                   size_t tag_len) {
-  const char **it;
+  const char *const *it;
 
   for (it = blacklist; *it; ++it) {
     if (is_tag(tag, tag_len, *it)) {
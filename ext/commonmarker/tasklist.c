@@ -120,6 +120,7 @@ static void html_render(cmark_syntax_extension *extension,
     cmark_html_render_cr(renderer->html);
     cmark_strbuf_puts(renderer->html, "<li");
     cmark_html_render_sourcepos(node, renderer->html, options);
+    cmark_html_render_attributes(renderer, CMARK_HTML_ATTRIBUTES_TASK_ITEM);
     cmark_strbuf_putc(renderer->html, '>');
     if (node->as.list.checked) {
       cmark_strbuf_puts(renderer->html, "<input type=\"checkbox\" checked=\"\" disabled=\"\" /> ");
@@ -0,0 +1,341 @@
+#include "texmath.h"
+#include <parser.h>
+#include <render.h>
+#include <html.h>
+#include <houdini.h>
+
+// `$...$` and `$$...$$` inside a paragraph are CMARK_NODE_MATH_INLINE and
+// CMARK_NODE_MATH_DISPLAY; a `$$` fence on its own line opens a
+// CMARK_NODE_MATH_BLOCK. All three keep their TeX source verbatim in the
+// node's content, so it is never parsed as Markdown.
+cmark_node_type CMARK_NODE_MATH_INLINE, CMARK_NODE_MATH_DISPLAY,
+    CMARK_NODE_MATH_BLOCK;
+
+typedef struct {
+  int fence_offset;
+  bool closed;
+} node_math_block;
+
+static bool is_space(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Returns the offset of the closing `$` (or the first `$` of `$$`), or 0 if
+// there is none. A backslash hides the next character, so `\$` is literal.
+static size_t scan_inline_math(const uint8_t *data, size_t size,
+                               bool display) {
+  size_t i = display ? 2 : 1;
+
+  // `$ x$` is not math, so that prices like "$5 and $10" are left alone.
+  if (i >= size || (!display && is_space(data[i])))
+    return 0;
+
+  for (; i < size; ++i) {
+    if (data[i] == '\\') {
+      ++i;
+    } else if (data[i] == '$') {
+      if (display) {
+        if (i + 1 < size && data[i + 1] == '$')
+          return i;
+      } else if (!is_space(data[i - 1]) &&
+                 (i + 1 == size || !cmark_isdigit(data[i + 1]))) {
+        return i;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static cmark_node *match(cmark_syntax_extension *self, cmark_parser *parser,
+                         cmark_node *parent, unsigned char c,
+                         cmark_inline_parser *inline_parser) {
+  cmark_chunk *chunk = cmark_inline_parser_get_chunk(inline_parser);
+  int offset = cmark_inline_parser_get_offset(inline_parser);
+  int start = cmark_inline_parser_get_column(inline_parser);
+  uint8_t *data = chunk->data + offset;
+  size_t size = chunk->len - offset;
+  bool display;
+  size_t delim, end;
+  cmark_node *node;
+
+  if (c != '$')
+    return NULL;
+
+  display = size > 1 && data[1] == '$';
+  delim = display ? 2 : 1;
+  end = scan_inline_math(data, size, display);
+
+  if (end == 0 || end == delim) {
+    // An unmatched or empty `$$` stays text as a whole, so that its second
+    // dollar cannot open an inline span of its own.
+    if (!display)
+      return NULL;
+    cmark_inline_parser_set_offset(inline_parser, offset + 2);
+    node = cmark_node_new_with_mem(CMARK_NODE_TEXT, parser->mem);
+    node->as.literal = cmark_chunk_dup(chunk, offset, 2);
+  } else {
+    cmark_inline_parser_set_offset(inline_parser, offset + (int)(end + delim));
+    node = cmark_node_new_with_mem(
+        display ? CMARK_NODE_MATH_DISPLAY : CMARK_NODE_MATH_INLINE,
+        parser->mem);
+    cmark_node_set_syntax_extension(node, self);
+    cmark_strbuf_put(&node->content, data + delim, (bufsize_t)(end - delim));
+  }
+
+  node->start_line = node->end_line =
+    cmark_inline_parser_get_line(inline_parser);
+  node->start_column = start - 1;
+  node->end_column = cmark_inline_parser_get_column(inline_parser) - 1;
+
+  return node;
+}
+
+// Returns true if the rest of the line after the first non-space character
+// is a `$$` fence.
+static bool is_math_fence(cmark_parser *parser, unsigned char *input,
+                          int len) {
+  int i = cmark_parser_get_first_nonspace(parser);
+
+  if (len - i < 2 || input[i] != '$' || input[i + 1] != '$')
+    return false;
+
+  for (i += 2; i < len; ++i) {
+    if (!is_space(input[i]))
+      return false;
+  }
+
+  return true;
+}
+
+static int line_end(unsigned char *input, int len) {
+  while (len > 0 && (input[len - 1] == '\n' || input[len - 1] == '\r'))
+    --len;
+  return len;
+}
+
+static cmark_node *try_opening_math_block(cmark_syntax_extension *self,
+                                          int indented, cmark_parser *parser,
+                                          cmark_node *parent_container,
+                                          unsigned char *input, int len) {
+  cmark_node *node;
+  node_math_block *math;
+
+  if (indented || parent_container->type == CMARK_NODE_MATH_BLOCK ||
+      !is_math_fence(parser, input, len))
+    return NULL;
+
+  node = cmark_parser_add_child(parser, parent_container,
+                                CMARK_NODE_MATH_BLOCK,
+                                cmark_parser_get_offset(parser));
+  cmark_node_set_syntax_extension(node, self);
+
+  math = (node_math_block *)parser->mem->calloc(1, sizeof(node_math_block));
+  math->fence_offset = cmark_parser_get_first_nonspace(parser) -
+                       cmark_parser_get_offset(parser);
+  node->as.opaque = math;
+
+  cmark_parser_advance_offset(parser, (char *)input,
+                              line_end(input, len) -
+                                  cmark_parser_get_offset(parser),
+                              false);
+
+  return node;
+}
+
+// Blocks that are still open take every line up to and including the
+// closing fence; there is no lazy continuation, as with fenced code.
+static int matches(cmark_syntax_extension *self, cmark_parser *parser,
+                   unsigned char *input, int len,
+                   cmark_node *parent_container) {
+  node_math_block *math = (node_math_block *)parent_container->as.opaque;
+  int offset = cmark_parser_get_offset(parser);
+  int end = line_end(input, len);
+  int i;
+
+  if (parent_container->type != CMARK_NODE_MATH_BLOCK || math->closed)
+    return 0;
+
+  if (cmark_parser_get_indent(parser) < 4 && is_math_fence(parser, input, len)) {
+    math->closed = true;
+  } else {
+    for (i = 0; i < math->fence_offset && offset + i < end &&
+                input[offset + i] == ' ';
+         ++i)
+      ;
+    cmark_strbuf_put(&parent_container->content, input + offset + i,
+                     end - offset - i);
+    cmark_strbuf_putc(&parent_container->content, '\n');
+  }
+
+  if (end > offset)
+    cmark_parser_advance_offset(parser, (char *)input, end - offset, false);
+
+  return 1;
+}
+
+static const char *get_type_string(cmark_syntax_extension *extension,
+                                   cmark_node *node) {
+  if (node->type == CMARK_NODE_MATH_INLINE)
+    return "math_inline";
+  if (node->type == CMARK_NODE_MATH_DISPLAY)
+    return "math_display";
+  if (node->type == CMARK_NODE_MATH_BLOCK)
+    return "math_block";
+
+  return "<unknown>";
+}
+
+static int can_contain(cmark_syntax_extension *extension, cmark_node *node,
+                       cmark_node_type child_type) {
+  return false;
+}
+
+static void opaque_free(cmark_syntax_extension *self, cmark_mem *mem,
+                        cmark_node *node) {
+  if (node->type == CMARK_NODE_MATH_BLOCK)
+    mem->free(node->as.opaque);
+}
+
+static const char *math_source(cmark_node *node) {
+  return (const char *)cmark_strbuf_cstr(&node->content);
+}
+
+static void commonmark_render(cmark_syntax_extension *extension,
+                              cmark_renderer *renderer, cmark_node *node,
+                              cmark_event_type ev_type, int options) {
+  if (ev_type != CMARK_EVENT_ENTER)
+    return;
+
+  if (node->type == CMARK_NODE_MATH_BLOCK) {
+    renderer->cr(renderer);
+    renderer->out(renderer, node, "$$", false, LITERAL);
+    renderer->cr(renderer);
+    renderer->out(renderer, node, math_source(node), false, LITERAL);
+    renderer->cr(renderer);
+    renderer->out(renderer, node, "$$", false, LITERAL);
+    renderer->blankline(renderer);
+  } else {
+    const char *delim = node->type == CMARK_NODE_MATH_DISPLAY ? "$$" : "$";
+    renderer->out(renderer, node, delim, false, LITERAL);
+    renderer->out(renderer, node, math_source(node), false, LITERAL);
+    renderer->out(renderer, node, delim, false, LITERAL);
+  }
+}
+
+static void latex_render(cmark_syntax_extension *extension,
+                         cmark_renderer *renderer, cmark_node *node,
+                         cmark_event_type ev_type, int options) {
+  if (ev_type != CMARK_EVENT_ENTER)
+    return;
+
+  if (node->type == CMARK_NODE_MATH_INLINE) {
+    renderer->out(renderer, node, "$", false, LITERAL);
+    renderer->out(renderer, node, math_source(node), false, LITERAL);
+    renderer->out(renderer, node, "$", false, LITERAL);
+  } else {
+    renderer->out(renderer, node, "\\[", false, LITERAL);
+    renderer->out(renderer, node, math_source(node), false, LITERAL);
+    renderer->out(renderer, node, "\\]", false, LITERAL);
+    if (node->type == CMARK_NODE_MATH_BLOCK)
+      renderer->blankline(renderer);
+  }
+}
+
+static void plaintext_render(cmark_syntax_extension *extension,
+                             cmark_renderer *renderer, cmark_node *node,
+                             cmark_event_type ev_type, int options) {
+  if (ev_type != CMARK_EVENT_ENTER)
+    return;
+
+  if (node->type == CMARK_NODE_MATH_BLOCK)
+    renderer->cr(renderer);
+  renderer->out(renderer, node, math_source(node), false, LITERAL);
+  if (node->type == CMARK_NODE_MATH_BLOCK)
+    renderer->blankline(renderer);
+}
+
+// The attributes of a math wrapper: the caller's template for it, or else
+// the ones client-side renderers look for by default.
+static void html_render_math_attributes(cmark_html_renderer *renderer,
+                                        cmark_html_attributes_slot slot,
+                                        const char *defaults) {
+  if (renderer->attributes && renderer->attributes->slots[slot])
+    cmark_html_render_attributes(renderer, slot);
+  else
+    cmark_strbuf_puts(renderer->html, defaults);
+}
+
+static void html_render(cmark_syntax_extension *extension,
+                        cmark_html_renderer *renderer, cmark_node *node,
+                        cmark_event_type ev_type, int options) {
+  cmark_strbuf *html = renderer->html;
+  bool delimiters = (options & CMARK_OPT_MATH_DELIMITERS) != 0;
+  const char *delim = node->type == CMARK_NODE_MATH_INLINE ? "$" : "$$";
+
+  if (ev_type != CMARK_EVENT_ENTER)
+    return;
+
+  if (node->type == CMARK_NODE_MATH_BLOCK) {
+    cmark_html_render_cr(html);
+    cmark_strbuf_puts(html, "<pre");
+    cmark_html_render_sourcepos(node, html, options);
+    cmark_strbuf_puts(html, "><code");
+    html_render_math_attributes(
+        renderer, CMARK_HTML_ATTRIBUTES_MATH_DISPLAY,
+        " class=\"language-math\" data-math-style=\"display\"");
+    cmark_strbuf_putc(html, '>');
+    if (delimiters)
+      cmark_strbuf_puts(html, "$$\n");
+  } else {
+    cmark_strbuf_puts(html, "<span");
+    if (node->type == CMARK_NODE_MATH_INLINE)
+      html_render_math_attributes(renderer, CMARK_HTML_ATTRIBUTES_MATH_INLINE,
+                                  " data-math-style=\"inline\"");
+    else
+      html_render_math_attributes(renderer, CMARK_HTML_ATTRIBUTES_MATH_DISPLAY,
+                                  " data-math-style=\"display\"");
+    cmark_strbuf_putc(html, '>');
+    if (delimiters)
+      cmark_strbuf_puts(html, delim);
+  }
+
+  houdini_escape_html0(html, node->content.ptr, node->content.size, 0);
+
+  if (node->type == CMARK_NODE_MATH_BLOCK) {
+    if (delimiters)
+      cmark_strbuf_puts(html, "$$");
+    cmark_strbuf_puts(html, "</code></pre>\n");
+  } else {
+    if (delimiters)
+      cmark_strbuf_puts(html, delim);
+    cmark_strbuf_puts(html, "</span>");
+  }
+}
+
+cmark_syntax_extension *create_math_extension(void) {
+  cmark_syntax_extension *ext = cmark_syntax_extension_new("math");
+  cmark_llist *special_chars = NULL;
+
+  cmark_syntax_extension_set_match_block_func(ext, matches);
+  cmark_syntax_extension_set_open_block_func(ext, try_opening_math_block);
+  cmark_syntax_extension_set_get_type_string_func(ext, get_type_string);
+  cmark_syntax_extension_set_can_contain_func(ext, can_contain);
+  cmark_syntax_extension_set_opaque_free_func(ext, opaque_free);
+  cmark_syntax_extension_set_commonmark_render_func(ext, commonmark_render);
+  cmark_syntax_extension_set_plaintext_render_func(ext, plaintext_render);
+  cmark_syntax_extension_set_latex_render_func(ext, latex_render);
+  cmark_syntax_extension_set_man_render_func(ext, plaintext_render);
+  cmark_syntax_extension_set_html_render_func(ext, html_render);
+  CMARK_NODE_MATH_INLINE = cmark_syntax_extension_add_node(1);
+  CMARK_NODE_MATH_DISPLAY = cmark_syntax_extension_add_node(1);
+  CMARK_NODE_MATH_BLOCK = cmark_syntax_extension_add_node(0);
+
+  cmark_syntax_extension_set_match_inline_func(ext, match);
+
+  cmark_mem *mem = cmark_get_default_mem_allocator();
+  special_chars = cmark_llist_append(mem, special_chars, (void *)'$');
+  cmark_syntax_extension_set_special_inline_chars(ext, special_chars);
+
+  return ext;
+}
@@ -0,0 +1,10 @@
+#ifndef CMARK_GFM_TEXMATH_H
+#define CMARK_GFM_TEXMATH_H
+
+#include "cmark-gfm-core-extensions.h"
+
+extern cmark_node_type CMARK_NODE_MATH_INLINE, CMARK_NODE_MATH_DISPLAY,
+    CMARK_NODE_MATH_BLOCK;
+cmark_syntax_extension *create_math_extension(void);
+
+#endif
@@ -0,0 +1,208 @@
+#include "wikilink.h"
+#include <parser.h>
+#include <render.h>
+#include <html.h>
+#include <houdini.h>
+#include <string.h>
+#include "scanners.h"
+
+// `[[Target]]` and `[[Target|label]]`. The target is kept in the node
+// content, and the label is its only TEXT child.
+cmark_node_type CMARK_NODE_WIKILINK;
+
+#define MAX_WIKILINK_LENGTH 512
+
+typedef struct {
+  bool missing;
+} node_wikilink;
+
+static bool is_space(uint8_t c) {
+  return c == ' ' || c == '\t';
+}
+
+static void trim(const uint8_t *data, size_t *start, size_t *end) {
+  while (*start < *end && is_space(data[*start]))
+    ++*start;
+  while (*end > *start && is_space(data[*end - 1]))
+    --*end;
+}
+
+static cmark_node *match(cmark_syntax_extension *self, cmark_parser *parser,
+                         cmark_node *parent, unsigned char c,
+                         cmark_inline_parser *inline_parser) {
+  cmark_chunk *chunk = cmark_inline_parser_get_chunk(inline_parser);
+  int offset = cmark_inline_parser_get_offset(inline_parser);
+  int start = cmark_inline_parser_get_column(inline_parser);
+  uint8_t *data = chunk->data + offset;
+  size_t size = chunk->len - offset;
+  size_t i, pipe = 0, target_start, target_end, label_start, label_end;
+
+  if (c != '[' || size < 5 || data[1] != '[')
+    return NULL;
+
+  // Like a link, a wikilink cannot be nested in the text of another link.
+  if (cmark_inline_parser_in_bracket(inline_parser, false) ||
+      cmark_inline_parser_in_bracket(inline_parser, true))
+    return NULL;
+
+  for (i = 2; i < size && i < MAX_WIKILINK_LENGTH; ++i) {
+    if (data[i] == ']')
+      break;
+    if (data[i] == '[' || data[i] == '\n' || data[i] == '\r')
+      return NULL;
+    if (data[i] == '|' && !pipe)
+      pipe = i;
+  }
+
+  if (i + 1 >= size || data[i] != ']' || data[i + 1] != ']')
+    return NULL;
+
+  target_start = 2;
+  target_end = pipe ? pipe : i;
+  trim(data, &target_start, &target_end);
+  label_start = pipe ? pipe + 1 : target_start;
+  label_end = pipe ? i : target_end;
+  trim(data, &label_start, &label_end);
+
+  if (target_start == target_end || label_start == label_end)
+    return NULL;
+
+  cmark_inline_parser_set_offset(inline_parser, offset + (int)i + 2);
+
+  cmark_node *node = cmark_node_new_with_mem(CMARK_NODE_WIKILINK, parser->mem);
+  cmark_node_set_syntax_extension(node, self);
+  node->as.opaque = parser->mem->calloc(1, sizeof(node_wikilink));
+  cmark_strbuf_put(&node->content, data + target_start,
+                   (bufsize_t)(target_end - target_start));
+
+  cmark_node *text = cmark_node_new_with_mem(CMARK_NODE_TEXT, parser->mem);
+  text->as.literal = cmark_chunk_dup(chunk, offset + (bufsize_t)label_start,
+                                     (bufsize_t)(label_end - label_start));
+  cmark_node_append_child(node, text);
+
+  node->start_line = text->start_line =
+    node->end_line = text->end_line =
+    cmark_inline_parser_get_line(inline_parser);
+
+  node->start_column = start - 1;
+  node->end_column = cmark_inline_parser_get_column(inline_parser) - 1;
+  text->start_column = node->start_column + (int)label_start;
+  text->end_column = node->start_column + (int)label_end - 1;
+
+  return node;
+}
+
+static const char *get_type_string(cmark_syntax_extension *extension,
+                                   cmark_node *node) {
+  return node->type == CMARK_NODE_WIKILINK ? "wikilink" : "<unknown>";
+}
+
+static int can_contain(cmark_syntax_extension *extension, cmark_node *node,
+                       cmark_node_type child_type) {
+  if (node->type != CMARK_NODE_WIKILINK)
+    return false;
+
+  return CMARK_NODE_TYPE_INLINE_P(child_type);
+}
+
+static void opaque_free(cmark_syntax_extension *self, cmark_mem *mem,
+                        cmark_node *node) {
+  mem->free(node->as.opaque);
+}
+
+static bool has_own_label(cmark_node *node) {
+  cmark_node *text = node->first_child;
+
+  return !text || text != node->last_child || text->type != CMARK_NODE_TEXT ||
+         text->as.literal.len != node->content.size ||
+         memcmp(text->as.literal.data, node->content.ptr,
+                node->content.size) != 0;
+}
+
+static void commonmark_render(cmark_syntax_extension *extension,
+                              cmark_renderer *renderer, cmark_node *node,
+                              cmark_event_type ev_type, int options) {
+  // Without a label of its own, the child text is the target.
+  if (ev_type == CMARK_EVENT_ENTER) {
+    renderer->out(renderer, node, "[[", false, LITERAL);
+    if (has_own_label(node)) {
+      renderer->out(renderer, node, cmark_strbuf_cstr(&node->content), false,
+                    LITERAL);
+      renderer->out(renderer, node, "|", false, LITERAL);
+    }
+  } else {
+    renderer->out(renderer, node, "]]", false, LITERAL);
+  }
+}
+
+// The other text formats only show the label.
+static void render(cmark_syntax_extension *extension,
+                   cmark_renderer *renderer, cmark_node *node,
+                   cmark_event_type ev_type, int options) {
+}
+
+static void html_render(cmark_syntax_extension *extension,
+                        cmark_html_renderer *renderer, cmark_node *node,
+                        cmark_event_type ev_type, int options) {
+  cmark_strbuf *html = renderer->html;
+  node_wikilink *wikilink = (node_wikilink *)node->as.opaque;
+  cmark_chunk target;
+
+  if (ev_type != CMARK_EVENT_ENTER) {
+    cmark_strbuf_puts(html, "</a>");
+    return;
+  }
+
+  target.data = node->content.ptr;
+  target.len = node->content.size;
+  target.alloc = 0;
+
+  cmark_strbuf_puts(html, "<a href=\"");
+  if ((options & CMARK_OPT_UNSAFE) || !scan_dangerous_url(&target, 0))
+    houdini_escape_href(html, target.data, target.len);
+  cmark_strbuf_puts(html, wikilink->missing
+                              ? "\" class=\"wikilink wikilink-missing\">"
+                              : "\" class=\"wikilink\">");
+}
+
+cmark_syntax_extension *create_wikilink_extension(void) {
+  cmark_syntax_extension *ext = cmark_syntax_extension_new("wikilink");
+
+  cmark_syntax_extension_set_get_type_string_func(ext, get_type_string);
+  cmark_syntax_extension_set_can_contain_func(ext, can_contain);
+  cmark_syntax_extension_set_opaque_free_func(ext, opaque_free);
+  cmark_syntax_extension_set_commonmark_render_func(ext, commonmark_render);
+  cmark_syntax_extension_set_plaintext_render_func(ext, render);
+  cmark_syntax_extension_set_latex_render_func(ext, render);
+  cmark_syntax_extension_set_man_render_func(ext, render);
+  cmark_syntax_extension_set_html_render_func(ext, html_render);
+  CMARK_NODE_WIKILINK = cmark_syntax_extension_add_node(1);
+
+  // '[' is special to the core inline parser already, which offers it to
+  // extensions before it opens a bracket.
+  cmark_syntax_extension_set_match_inline_func(ext, match);
+
+  return ext;
+}
+
+const char *cmark_gfm_extensions_get_wikilink_target(cmark_node *node) {
+  if (!node || node->type != CMARK_NODE_WIKILINK)
+    return NULL;
+
+  return cmark_strbuf_cstr(&node->content);
+}
+
+bool cmark_gfm_extensions_get_wikilink_missing(cmark_node *node) {
+  if (!node || node->type != CMARK_NODE_WIKILINK)
+    return false;
+
+  return ((node_wikilink *)node->as.opaque)->missing;
+}
+
+int cmark_gfm_extensions_set_wikilink_missing(cmark_node *node, bool missing) {
+  if (!node || node->type != CMARK_NODE_WIKILINK)
+    return 0;
+
+  ((node_wikilink *)node->as.opaque)->missing = missing;
+  return 1;
+}
@@ -0,0 +1,9 @@
+#ifndef CMARK_GFM_WIKILINK_H
+#define CMARK_GFM_WIKILINK_H
+
+#include "cmark-gfm-core-extensions.h"
+
+extern cmark_node_type CMARK_NODE_WIKILINK;
+cmark_syntax_extension *create_wikilink_extension(void);
+
+#endif
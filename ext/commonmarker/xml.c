@@ -6,6 +6,7 @@
 #include "config.h"
 #include "cmark-gfm.h"
 #include "node.h"
+#include "probes.h"
 #include "buffer.h"
 #include "houdini.h"
 #include "syntax_extension.h"
@@ -164,16 +165,22 @@ char *cmark_render_xml_with_mem(cmark_node *root, int options, cmark_mem *mem) {
   cmark_event_type ev_type;
   cmark_node *cur;
   struct render_state state = {&xml, 0};
+  size_t nodes = 0;
 
   cmark_iter *iter = cmark_iter_new(root);
 
+  CMARK_PROBE2(render__start, "xml", options);
+
   cmark_strbuf_puts(state.xml, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
   cmark_strbuf_puts(state.xml,
                     "<!DOCTYPE document SYSTEM \"CommonMark.dtd\">\n");
   while ((ev_type = cmark_iter_next(iter)) != CMARK_EVENT_DONE) {
     cur = cmark_iter_get_node(iter);
     S_render_node(cur, ev_type, &state, options);
+    if (ev_type == CMARK_EVENT_ENTER)
+      nodes++;
   }
+  CMARK_PROBE3(render__done, "xml", (size_t)xml.size, nodes);
   result = (char *)cmark_strbuf_detach(&xml);
 
   cmark_iter_free(iter);
@@ -3,6 +3,7 @@
 
 require 'commonmarker/commonmarker'
 require 'commonmarker/config'
+require 'commonmarker/html_attributes'
 require 'commonmarker/node'
 require 'commonmarker/renderer'
 require 'commonmarker/renderer/html_renderer'
@@ -12,18 +13,41 @@ begin
   require 'awesome_print'
 rescue LoadError; end # rubocop:disable Lint/SuppressedException
 module CommonMarker
+  class << self
+    # Public: A {SharedCache} that render_html looks documents up in before
+    # rendering them, or nil (the default) to always render.
+    attr_accessor :shared_cache
+  end
+
   # Public:  Parses a Markdown string into an HTML string.
   #
   # text - A {String} of text
   # option - Either a {Symbol} or {Array of Symbol}s indicating the render options
   # extensions - An {Array of Symbol}s indicating the extensions to use
+  # attributes - An optional {HtmlAttributes} to add to the generated elements
+  # deadline - An optional {Integer} time, in nanoseconds on the monotonic
+  #            clock, after which to give up and raise {Timeout}
+  # wikilinks - An optional callable that looks up the pages linked to by the
+  #             `:wikilink` extension in one batch; see Node#resolve_wikilinks
+  # resolver - An optional block that resolves the references found by the
+  #            `:mention` extension in one batch; see Node#resolve_mentions
   #
   # Returns a {String} of converted HTML.
-  def self.render_html(text, options = :DEFAULT, extensions = [])
+  def self.render_html(text, options = :DEFAULT, extensions = [], attributes: nil, deadline: nil, wikilinks: nil, &resolver)
     raise TypeError, "text must be a String; got a #{text.class}!" unless text.is_a?(String)
 
     opts = Config.process_options(options, :render)
-    Node.markdown_to_html(text.encode('UTF-8'), opts, extensions)
+    text = text.encode('UTF-8')
+    unless resolver || wikilinks || attributes
+      return Node.markdown_to_html(text, opts, extensions, deadline) unless shared_cache
+
+      return shared_cache.fetch(text, opts, extensions) { Node.markdown_to_html(text, opts, extensions, deadline) }
+    end
+
+    doc = Node.parse_document(text, text.bytesize, opts, extensions, deadline)
+    doc.resolve_mentions(&resolver) if resolver
+    doc.resolve_wikilinks(&wikilinks) if wikilinks
+    doc.to_html(options, extensions, attributes: attributes, deadline: deadline)
   end
 
   # Public: Parses a Markdown string into a `document` node.
@@ -31,13 +55,146 @@ module CommonMarker
   # string - {String} to be parsed
   # option - A {Symbol} or {Array of Symbol}s indicating the parse options
   # extensions - An {Array of Symbol}s indicating the extensions to use
+  # deadline - An optional {Integer} time, in nanoseconds on the monotonic
+  #            clock, after which to give up and raise {Timeout}
+  # compact - Whether to copy the parsed tree into one block of memory, in
+  #           document order, which makes rendering and walking a large
+  #           document that is used many times faster
   #
   # Returns the `document` node.
-  def self.render_doc(text, options = :DEFAULT, extensions = [])
+  def self.render_doc(text, options = :DEFAULT, extensions = [], deadline: nil, compact: false)
     raise TypeError, "text must be a String; got a #{text.class}!" unless text.is_a?(String)
 
     opts = Config.process_options(options, :parse)
     text = text.encode('UTF-8')
-    Node.parse_document(text, text.bytesize, opts, extensions)
+    Node.parse_document(text, text.bytesize, opts, extensions, deadline, compact)
+  end
+
+  # Public: Loads native syntax extensions from a shared object, after which
+  # they can be named in `extensions` like the built-in ones. The object
+  # exports a `cmark_plugin_init_func` that registers its extensions with
+  # `cmark_plugin_register_syntax_extension`, and is built against the
+  # headers in the gem's ext/commonmarker directory. Load extensions before
+  # forking workers, and before starting threads that render.
+  #
+  # path - The {String} path of the shared object
+  # init - The name of the init function; by default `init_` followed by
+  #        the file name without its extension, dashes turned to underscores
+  #
+  # Returns an {Array} of the names of the extensions it registered.
+  def self.load_extension(path, init: nil)
+    init ||= "init_#{File.basename(path.to_s, '.*').tr('-', '_')}"
+    Node.load_extension(path.to_s, init)
+  end
+
+  # Public: Renders a Markdown string to HTML, counting the native memory
+  # allocated on the way. Meant for sizing and for spotting regressions, not
+  # for production: profiling is slower, and one profile runs at a time.
+  #
+  # text - A {String} of text
+  # option - Either a {Symbol} or {Array of Symbol}s indicating the render options
+  # extensions - An {Array of Symbol}s indicating the extensions to use
+  #
+  # Returns a {Hash}. Under `:phases`, the `:blocks`, `:inlines`,
+  # `:postprocess` and `:render` phases each count their `:allocs`,
+  # `:reallocs` and `:frees`, the `:bytes` requested and the `:peak_live`
+  # bytes. `:peak_live` is the peak over the whole run. `:retained` is what
+  # the parsed tree held once the parser was freed. `:node_types` maps each
+  # node type to the `:count` of such nodes and the `:bytes` they held once
+  # parsed (the node, its content buffer and its literals). `:output` has
+  # the `:html` rendered, its `:bytes` and the bytes `:allocated` for it.
+  def self.memory_profile(text, options = :DEFAULT, extensions = [])
+    raise TypeError, "text must be a String; got a #{text.class}!" unless text.is_a?(String)
+
+    opts = Config.process_options(options, :render)
+    Node.memory_profile(text.encode('UTF-8'), opts, extensions)
+  end
+
+  # Public: Reads the latency histograms kept while `metrics_enabled` is
+  # set. Parsing and HTML rendering are timed in every thread, and recorded
+  # by operation, extension set and input size class.
+  #
+  # reset - Whether to zero the histograms as they are read
+  #
+  # Returns a {Hash}. `:series` is an {Array} of {Hash}es, one for each
+  # `:operation` (`:parse` or `:render`), `:extensions` set and input size
+  # class from `:min_bytes` up to `:max_bytes` (exclusive, nil for the
+  # largest class) that has been recorded. Each has the `:count`, the
+  # `:total_ns` and `:max_ns`, and `:buckets` as `[min_ns, max_ns, count]`
+  # triples. `:dropped` counts what went unrecorded because there were too
+  # many extension sets.
+  def self.metrics(reset: false)
+    Node.metrics(reset)
+  end
+
+  # Public: Starts keeping the inputs that take longer than `threshold` to
+  # parse and render, to find out which documents cause latency outliers.
+  # Inputs that run past their deadline are kept too. Only the latest
+  # `capacity` inputs are kept; calling this again drops them all.
+  #
+  # threshold - The {Float} seconds above which an input is kept, or nil to
+  #             stop keeping them
+  # capacity - The number of inputs to keep
+  # max_bytes - How much of each input to keep
+  def self.capture_slow_inputs(threshold:, capacity: 32, max_bytes: 64 * 1024)
+    Node.capture_slow_inputs(threshold && (threshold * 1_000_000_000).to_i, capacity, max_bytes)
+  end
+
+  # Public: Returns the inputs kept since capture_slow_inputs, oldest first.
+  #
+  # clear - Whether to forget them afterwards
+  #
+  # Returns an {Array} of {Hash}es, each with the `:input` (its first
+  # `max_bytes`), `:input_bytes`, whether it was `:truncated`, a `:digest`
+  # of the whole input, the `:options` and `:extensions` it was rendered
+  # with, the `:parse_ns` and `:render_ns` it took (nil for a phase that did
+  # not run), whether it `:timed_out`, and when it was kept, `:at`.
+  def self.slow_inputs(clear: false)
+    Node.slow_inputs(clear)
+  end
+
+  # Public: Writes the slow inputs to `path` as JSON lines, for replaying
+  # with `rake replay[path]`.
+  #
+  # Returns the number of inputs written.
+  def self.dump_slow_inputs(path, clear: false)
+    require 'json'
+
+    inputs = slow_inputs(clear: clear)
+    File.open(path, 'w') do |file|
+      inputs.each { |input| file.puts(JSON.generate(input.merge(at: input[:at].utc.strftime('%FT%T.%6NZ')))) }
+    end
+    inputs.length
+  end
+
+  # Public: Counts the task list items in a Markdown string. Only the block
+  # structure is parsed, and nothing is rendered.
+  #
+  # text - A {String} of text
+  # option - Either a {Symbol} or {Array of Symbol}s indicating the parse options
+  #
+  # Returns a {Hash} with the `:total` and `:checked` item counts, and the
+  # `:items` as `[line, checked]` pairs in document order.
+  def self.tasklist_summary(text, options = :DEFAULT)
+    raise TypeError, "text must be a String; got a #{text.class}!" unless text.is_a?(String)
+
+    opts = Config.process_options(options, :parse)
+    Node.markdown_to_tasklist_summary(text.encode('UTF-8'), opts)
+  end
+
+  # Public: Parses a Markdown string and extracts its tables, without
+  # creating any nodes on the Ruby side.
+  #
+  # text - A {String} of text
+  # option - Either a {Symbol} or {Array of Symbol}s indicating the render options
+  # extensions - An {Array of Symbol}s indicating the extensions to use; `:table` is always added
+  # format - Either `:plaintext` or `:html`, indicating how cell contents are rendered
+  #
+  # Returns an {Array} of {Hash}es; see Node#tables.
+  def self.extract_tables(text, options = :DEFAULT, extensions = [], format = :plaintext)
+    raise TypeError, "text must be a String; got a #{text.class}!" unless text.is_a?(String)
+
+    opts = Config.process_options(options, :render)
+    Node.markdown_to_tables(text.encode('UTF-8'), opts, Array(extensions) | [:table], Node.html_table_cells?(format))
   end
 end
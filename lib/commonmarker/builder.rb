@@ -0,0 +1,163 @@
+# frozen_string_literal: true
+
+require 'digest'
+require 'fileutils'
+require 'json'
+
+module CommonMarker
+  # Public: Converts a directory tree of Markdown files, writing each output
+  # file to the mirrored path under another directory. Files are converted by
+  # a pool of forked worker processes, and a manifest of content hashes lets
+  # later runs skip the files that did not change.
+  class Builder
+    MANIFEST = '.commonmarker-manifest.json'
+    SOURCES = '**/*.{md,markdown}'
+    FORMAT_EXTENSIONS = { html: '.html', xml: '.xml', commonmark: '.md', plaintext: '.txt' }.freeze
+
+    Result = Struct.new(:built, :unchanged, :removed, :failed, :bytes, :seconds) do
+      def to_s
+        rate = seconds.positive? ? built / seconds : 0.0
+        format('%<built>d built, %<unchanged>d unchanged, %<removed>d removed, %<failed>d failed ' \
+               'in %<seconds>.2fs (%<rate>.1f files/s, %<mb>.2f MB/s)',
+               built: built, unchanged: unchanged, removed: removed, failed: failed, seconds: seconds,
+               rate: rate, mb: seconds.positive? ? bytes / seconds / 1_000_000 : 0.0)
+      end
+    end
+
+    # Public: Sets up a build of every Markdown file under `source` into
+    # `output`.
+    #
+    # source - The {String} directory to read `*.md` and `*.markdown` files from
+    # output - The {String} directory to write to; created if needed
+    # parse_options - The parse options, as for CommonMarker.render_doc
+    # render_options - The render options, as for Node#to_html
+    # extensions - An {Array of Symbol}s indicating the extensions to use
+    # format - One of Config::OPTS[:format]
+    # jobs - The number of worker processes
+    def initialize(source, output, parse_options: :DEFAULT, render_options: :DEFAULT, extensions: [],
+                   format: :html, jobs: 1)
+      raise ArgumentError, "format '#{format}' not found" unless FORMAT_EXTENSIONS.key?(format)
+      raise ArgumentError, 'jobs must be positive' unless jobs.positive?
+
+      @source = File.expand_path(source)
+      @output = File.expand_path(output)
+      @parse_options = parse_options
+      @render_options = render_options
+      @extensions = extensions
+      @format = format
+      @jobs = Process.respond_to?(:fork) ? jobs : 1
+      @signature = signature
+    end
+
+    # Public: Converts the files that changed since the last run, and removes
+    # the output of sources that are gone.
+    #
+    # Returns a {Result}.
+    def run
+      started = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      FileUtils.mkdir_p(@output)
+
+      previous = load_manifest
+      paths = Dir.glob(SOURCES, base: @source).select { |path| File.file?(File.join(@source, path)) }
+      hashes = paths.sort.to_h { |path| [path, Digest::SHA256.file(File.join(@source, path)).hexdigest] }
+      stale = hashes.keys.reject { |path| previous[path] == hashes[path] && File.exist?(output_path(path)) }
+
+      removed = (previous.keys - hashes.keys).each { |path| FileUtils.rm_f(output_path(path)) }
+      built = convert_all(stale)
+
+      manifest = previous.slice(*(hashes.keys - stale))
+      built.each { |path| manifest[path] = hashes[path] }
+      save_manifest(manifest)
+
+      Result.new(built.length, hashes.length - stale.length, removed.length, stale.length - built.length,
+                 built.sum { |path| File.size(File.join(@source, path)) },
+                 Process.clock_gettime(Process::CLOCK_MONOTONIC) - started)
+    end
+
+    private
+
+    def signature
+      [VERSION, @format, Config.process_options(@parse_options, :parse),
+       Config.process_options(@render_options, :render), @extensions.map(&:to_s).sort].join(' ')
+    end
+
+    def load_manifest
+      manifest = JSON.parse(File.read(File.join(@output, MANIFEST)))
+      manifest['signature'] == @signature ? manifest['files'] : {}
+    rescue Errno::ENOENT, JSON::ParserError
+      {}
+    end
+
+    def save_manifest(files)
+      path = File.join(@output, MANIFEST)
+      File.write("#{path}.tmp", JSON.generate('signature' => @signature, 'files' => files))
+      File.rename("#{path}.tmp", path)
+    end
+
+    def output_path(path)
+      File.join(@output, path.sub(/\.[^.]+\z/, FORMAT_EXTENSIONS[@format]))
+    end
+
+    # Converts the files in worker processes, balancing them by size, and
+    # returns the paths that were converted. Each worker reports the paths it
+    # converted as it goes; all of the pipes are drained at once, so that no
+    # worker stalls on a full pipe while the others are read.
+    def convert_all(paths)
+      return paths.select { |path| convert(path) } if @jobs == 1 || paths.length < 2
+
+      slices = Array.new([@jobs, paths.length].min) { [] }
+      loads = Array.new(slices.length, 0)
+      paths.sort_by { |path| -File.size(File.join(@source, path)) }.each do |path|
+        index = loads.index(loads.min)
+        slices[index] << path
+        loads[index] += File.size(File.join(@source, path))
+      end
+
+      workers = slices.map do |slice|
+        reader, writer = IO.pipe
+        pid = fork do
+          reader.close
+          slice.each { |path| writer.puts(path) if convert(path) }
+          writer.close
+          exit!(0)
+        end
+        writer.close
+        [pid, reader]
+      end
+
+      reports = workers.to_h { |_, reader| [reader, +''] }
+      done = []
+      until reports.empty?
+        IO.select(reports.keys).first.each do |reader|
+          reports[reader] << reader.read_nonblock(64 * 1024)
+        rescue EOFError
+          done.concat(reports.delete(reader).lines(chomp: true))
+          reader.close
+        end
+      end
+      workers.each { |pid, _| Process.wait(pid) }
+      done
+    end
+
+    def convert(path)
+      doc = CommonMarker.render_doc(File.read(File.join(@source, path), encoding: 'utf-8'),
+                                    @parse_options, @extensions)
+      out = output_path(path)
+      FileUtils.mkdir_p(File.dirname(out))
+      File.write(out, render(doc))
+      true
+    rescue StandardError => e
+      warn "#{path}: #{e.message}"
+      false
+    end
+
+    def render(doc)
+      case @format
+      when :html then doc.to_html(@render_options, @extensions)
+      when :xml then doc.to_xml(@render_options)
+      when :commonmark then doc.to_commonmark(@render_options)
+      when :plaintext then doc.to_plaintext(@render_options)
+      end
+    end
+  end
+end
@@ -28,7 +28,9 @@ module CommonMarker
         FOOTNOTES: (1 << 13),
         STRIKETHROUGH_DOUBLE_TILDE: (1 << 14),
         TABLE_PREFER_STYLE_ATTRIBUTES: (1 << 15),
-        FULL_INFO_STRING: (1 << 16)
+        FULL_INFO_STRING: (1 << 16),
+        MATH_DELIMITERS: (1 << 19),
+        COMPACT_HTML: (1 << 20)
       }.freeze,
       format: %i[html xml commonmark plaintext].freeze
     }.freeze
@@ -0,0 +1,58 @@
+# frozen_string_literal: true
+
+module CommonMarker
+  # Public: A frozen table of extra attributes for the elements generated by
+  # Node#to_html, compiled once and reused for every render:
+  #
+  #   ATTRIBUTES = CommonMarker::HtmlAttributes.new(
+  #     table: { class: 'table' },
+  #     image: { loading: 'lazy' },
+  #     external_link: { rel: 'nofollow' },
+  #     code_language_prefix: 'highlight-'
+  #   )
+  #   doc.to_html(:DEFAULT, [], attributes: ATTRIBUTES)
+  #
+  # `external_link` attributes go to links to other sites ("https://...",
+  # "//..."), after the `link` ones; autolinks count as links.
+  # `strikethrough` and `task_item` go to the `<del>` and `<li>` elements of
+  # those extensions. `math_inline` and `math_display` replace the default
+  # attributes of the math extension's wrappers, for client-side renderers
+  # that look for something else. `code_language_prefix` replaces the
+  # `language-` prefix of the class of fenced code.
+  class HtmlAttributes
+    # The elements attributes can be given for, in the order of
+    # cmark_html_attributes_slot.
+    SLOTS = %i[blockquote list header code_block paragraph code link external_link image table
+               strikethrough task_item math_inline math_display].freeze
+
+    NAME_RE = /\A[a-zA-Z_:][-a-zA-Z0-9_:.]*\z/.freeze
+    ESCAPES = { '&' => '&amp;', '<' => '&lt;', '>' => '&gt;', '"' => '&quot;' }.freeze
+
+    attr_reader :native
+
+    def initialize(code_language_prefix: nil, **attributes)
+      unknown = attributes.keys - SLOTS
+      raise TypeError, "unknown element(s) #{unknown.join(', ')}; expected one of #{SLOTS.join(', ')}" unless unknown.empty?
+
+      slots = SLOTS.map { |slot| attributes[slot] && compile(attributes[slot]) }
+      @native = [*slots, code_language_prefix && escape(code_language_prefix)].freeze
+      freeze
+    end
+
+    private
+
+    def compile(attributes)
+      raise TypeError, "attributes must be a Hash; got a #{attributes.class}" unless attributes.is_a?(Hash)
+
+      attributes.map do |name, value|
+        raise TypeError, "invalid attribute name #{name.inspect}" unless NAME_RE.match?(name.to_s)
+
+        %( #{name}="#{escape(value)}")
+      end.join.freeze
+    end
+
+    def escape(value)
+      value.to_s.gsub(/[&<>"]/, ESCAPES).freeze
+    end
+  end
+end
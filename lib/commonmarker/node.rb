@@ -23,11 +23,38 @@ module CommonMarker
     #
     # options - A {Symbol} or {Array of Symbol}s indicating the render options
     # extensions - An {Array of Symbol}s indicating the extensions to use
+    # attributes - An optional {HtmlAttributes} to add to the generated elements
+    # compress - `:deflate` or `:gzip` to get the HTML compressed, deflating it
+    #            as it is rendered rather than building it all up first
+    # level - The compression level, from 0 to 9 (defaults to zlib's default)
+    # deadline - An optional {Integer} time, in nanoseconds on the monotonic
+    #            clock, after which to give up and raise {Timeout}
     #
-    # Returns a {String}.
-    def to_html(options = :DEFAULT, extensions = [])
+    # Returns a {String}; a binary one when compressed.
+    def to_html(options = :DEFAULT, extensions = [], attributes: nil, compress: nil, level: nil, deadline: nil)
+      opts = Config.process_options(options, :render)
+      return _render_html_compressed(opts, extensions, attributes&.native, compress, level || -1, deadline) if compress
+
+      _render_html(opts, extensions, attributes&.native, deadline).force_encoding('utf-8')
+    end
+
+    # Public: Renders the node to HTML a few nodes at a time, yielding the
+    # output in pieces. Fiber-based servers can let other fibers run between
+    # pieces instead of blocking for the whole render. Don't modify the tree
+    # until rendering is over.
+    #
+    # options - A {Symbol} or {Array of Symbol}s indicating the render options
+    # extensions - An {Array of Symbol}s indicating the extensions to use
+    # attributes - An optional {HtmlAttributes} to add to the generated elements
+    # nodes - The most iterator steps (node entries and exits) per piece
+    # bytes - Stop a step early once this many bytes are pending
+    #
+    # Returns an {Enumerator} of {String}s unless a block is given.
+    def each_chunk(options = :DEFAULT, extensions = [], attributes: nil, nodes: 1000, bytes: 16 * 1024)
+      return enum_for(__method__, options, extensions, attributes: attributes, nodes: nodes, bytes: bytes) unless block_given?
+
       opts = Config.process_options(options, :render)
-      _render_html(opts, extensions).force_encoding('utf-8')
+      _each_html_chunk(opts, extensions, attributes&.native, nodes, bytes) { |chunk| yield chunk }
     end
 
     # Public: Convert the node to an XML string.
@@ -62,6 +89,28 @@ module CommonMarker
       _render_plaintext(opts, width).force_encoding('utf-8')
     end
 
+    # Public: Extract every table below the node as plain Ruby data.
+    #
+    # format - Either `:plaintext` or `:html`, indicating how cell contents are rendered
+    # options - A {Symbol} or {Array of Symbol}s indicating the render options
+    #
+    # Returns an {Array} with one {Hash} per table, holding the column
+    # `:alignments`, the `:header` cells and the body `:rows` of cells.
+    def tables(format = :plaintext, options = :DEFAULT)
+      opts = Config.process_options(options, :render)
+      _tables(Node.html_table_cells?(format), opts)
+    end
+
+    # Internal: Whether cells should be rendered as HTML for the given format.
+    def self.html_table_cells?(format)
+      case format
+      when :plaintext then false
+      when :html then true
+      else
+        raise TypeError, "table cell format must be :plaintext or :html; got #{format.inspect}"
+      end
+    end
+
     # Public: Iterate over the children (if any) of the current pointer.
     def each
       return enum_for(:each) unless block_given?
@@ -212,6 +212,31 @@ module CommonMarker
       out('<del>', :children, '</del>')
     end
 
+    def mention(_)
+      out(:children)
+    end
+
+    def wikilink(node)
+      klass = node.wikilink_missing? ? 'wikilink wikilink-missing' : 'wikilink'
+      out('<a href="', escape_href(node.wikilink_target), "\" class=\"#{klass}\">", :children, '</a>')
+    end
+
+    def math_inline(node)
+      out('<span data-math-style="inline">', math_source(node, '$'), '</span>')
+    end
+
+    def math_display(node)
+      out('<span data-math-style="display">', math_source(node, '$$'), '</span>')
+    end
+
+    def math_block(node)
+      block do
+        out("<pre#{sourcepos(node)}><code class=\"language-math\" data-math-style=\"display\">")
+        out(math_source(node, "$$\n", '$$'))
+        out("</code></pre>\n")
+      end
+    end
+
     def footnote_reference(node)
       out("<sup class=\"footnote-ref\"><a href=\"#fn#{node.string_content}\" id=\"fnref#{node.string_content}\">#{node.string_content}</a></sup>")
     end
@@ -241,6 +266,11 @@ module CommonMarker
       true
     end
 
+    def math_source(node, open, close = open)
+      source = escape_html(node.string_content)
+      option_enabled?(:MATH_DELIMITERS) ? "#{open}#{source}#{close}" : source
+    end
+
     def tasklist?(node)
       node.type_string == 'tasklist'
     end
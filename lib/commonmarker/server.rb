@@ -0,0 +1,132 @@
+# frozen_string_literal: true
+
+require 'socket'
+
+module CommonMarker
+  # Public: Renders Markdown to HTML for other processes over a Unix domain
+  # socket, so that they don't pay for starting Ruby for every document.
+  #
+  # Each connection carries any number of requests, answered in order. A
+  # request is three unsigned 32-bit big-endian integers: the render options
+  # (the bits of Config::OPTS), the byte length of the extension names and
+  # the byte length of the input; followed by the comma-separated extension
+  # names and the UTF-8 input. A response is a status (0 for success, 1 for
+  # an error) and a byte length as two more such integers, followed by the
+  # HTML or the error message.
+  #
+  # Connections are served on their own threads, and documents are rendered
+  # with the GVL released, so they are rendered concurrently.
+  class Server
+    HEADER = 'NNN'
+    RESPONSE = 'NN'
+    MAX_REQUEST = 64 * 1024 * 1024
+
+    OK = 0
+    ERROR = 1
+
+    # Public: Listens on a socket at `path`, replacing a stale socket file
+    # left behind by a server that is gone.
+    def initialize(path)
+      @path = path
+      remove_stale_socket
+      @server = UNIXServer.new(path)
+    end
+
+    # Public: Accepts and serves connections until `close` is called.
+    def run
+      loop do
+        client = @server.accept
+        Thread.new(client) { |socket| serve(socket) }
+      end
+    rescue IOError, Errno::EBADF
+      nil
+    end
+
+    # Public: Stops accepting connections and removes the socket file.
+    def close
+      @server.close
+      File.unlink(@path) if File.socket?(@path)
+    end
+
+    private
+
+    def remove_stale_socket
+      return unless File.socket?(@path)
+
+      UNIXSocket.new(@path).close
+    rescue Errno::ECONNREFUSED, Errno::ENOENT
+      File.unlink(@path)
+    end
+
+    def serve(socket)
+      while (header = socket.read(12)) && header.bytesize == 12
+        options, extensions_len, input_len = header.unpack(HEADER)
+        if extensions_len + input_len > MAX_REQUEST
+          respond(socket, ERROR, "request larger than #{MAX_REQUEST} bytes")
+          break
+        end
+
+        extensions = read(socket, extensions_len).split(',').map(&:to_sym)
+        input = read(socket, input_len).force_encoding('utf-8')
+        render(socket, input, options, extensions)
+      end
+    rescue EOFError, SystemCallError
+      nil
+    ensure
+      socket.close
+    end
+
+    def read(socket, len)
+      data = socket.read(len) || ''
+      raise EOFError if data.bytesize < len
+
+      data
+    end
+
+    def render(socket, input, options, extensions)
+      html = Node.markdown_to_html(input, options, extensions, nil, true)
+      respond(socket, OK, html)
+    rescue StandardError => e
+      respond(socket, ERROR, e.message)
+    end
+
+    def respond(socket, status, body)
+      socket.write([status, body.bytesize].pack(RESPONSE), body)
+    end
+  end
+
+  # Public: Sends documents to a Server to be rendered.
+  class Client
+    # Raised when the server could not render a document.
+    class Error < StandardError; end
+
+    def initialize(path)
+      @socket = UNIXSocket.new(path)
+    end
+
+    # Public: Renders a document on the server.
+    #
+    # text - A {String} of text
+    # options - Either a {Symbol} or {Array of Symbol}s indicating the render options
+    # extensions - An {Array of Symbol}s indicating the extensions to use
+    #
+    # Returns a {String} of HTML.
+    def render_html(text, options = :DEFAULT, extensions = [])
+      text = text.encode('UTF-8')
+      names = extensions.join(',')
+      opts = Config.process_options(options, :render)
+      @socket.write([opts, names.bytesize, text.bytesize].pack(Server::HEADER), names, text)
+
+      status, len = (@socket.read(8) || raise(EOFError)).unpack(Server::RESPONSE)
+      body = len.zero? ? +'' : @socket.read(len)
+      raise EOFError if body.nil? || body.bytesize < len
+      raise Error, body unless status == Server::OK
+
+      body.force_encoding('utf-8')
+    end
+
+    def close
+      @socket.close
+    end
+  end
+end
@@ -0,0 +1,99 @@
+# frozen_string_literal: true
+
+# Measures what each public entry point costs per call on small documents,
+# where the Ruby side of the binding (option processing, encoding, looking
+# up extensions, allocating parsers and Strings) is much of the work. Counts
+# the Ruby objects each call allocates, and fails if a count grows past its
+# limit in test/binding_allocations.json; UPDATE_THRESHOLDS=1 rewrites the
+# limits from this run.
+#
+#   rake benchmark:binding
+
+require 'json'
+require 'commonmarker'
+
+LIMITS = File.expand_path('binding_allocations.json', __dir__)
+SIZES = [50, 200, 1024, 4096].freeze
+SAMPLE = <<~MARKDOWN
+  # A heading
+
+  Some *emphasis*, **strong** text and a [link](https://example.com "title").
+  A second line with `code` and an ![image](img.png).
+
+  - one
+  - two
+
+  > quoted
+
+MARKDOWN
+
+def input_of(size)
+  (SAMPLE * ((size / SAMPLE.bytesize) + 1)).byteslice(0, size).freeze
+end
+
+ENTRY_POINTS = {
+  'render_html' => ->(text, _doc) { CommonMarker.render_html(text) },
+  'render_html (gfm)' => ->(text, _doc) { CommonMarker.render_html(text, :DEFAULT, %i[table strikethrough autolink tagfilter tasklist]) },
+  'render_doc' => ->(text, _doc) { CommonMarker.render_doc(text) },
+  'to_html' => ->(_text, doc) { doc.to_html },
+  'to_commonmark' => ->(_text, doc) { doc.to_commonmark },
+  'to_xml' => ->(_text, doc) { doc.to_xml },
+  'to_plaintext' => ->(_text, doc) { doc.to_plaintext },
+  'walk' => ->(_text, doc) { doc.walk { |node| node } },
+  'accessors' => lambda do |_text, doc|
+    doc.walk do |node|
+      node.type
+      node.sourcepos
+      node.string_content if node.type == :text
+      node.url if node.type == :link
+    end
+  end
+}.freeze
+
+# Returns the best time per call over a few batches, in nanoseconds, and
+# the objects allocated per call.
+def measure(text, doc, call)
+  iterations = 200
+  iterations *= 2 while timed(iterations) { call.call(text, doc) } < 0.02
+
+  best = Array.new(5) { timed(iterations) { call.call(text, doc) } }.min
+  before = GC.stat(:total_allocated_objects)
+  iterations.times { call.call(text, doc) }
+  allocated = GC.stat(:total_allocated_objects) - before
+
+  [best * 1e9 / iterations, allocated.to_f / iterations]
+end
+
+def timed(iterations)
+  started = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+  iterations.times { yield }
+  Process.clock_gettime(Process::CLOCK_MONOTONIC) - started
+end
+
+report = {}
+printf("%-20s %6s %12s %14s\n", 'entry point', 'bytes', 'ns/call', 'objects/call')
+ENTRY_POINTS.each do |name, call|
+  SIZES.each do |size|
+    text = input_of(size)
+    doc = CommonMarker.render_doc(text)
+    ns, objects = measure(text, doc, call)
+    report["#{name} #{size}"] = objects
+    printf("%-20s %6d %12.0f %14.1f\n", name, size, ns, objects)
+  end
+end
+
+if ENV['UPDATE_THRESHOLDS']
+  File.write(LIMITS, "#{JSON.pretty_generate(report.transform_values(&:ceil))}\n")
+  warn "wrote #{LIMITS}"
+  exit
+end
+
+limits = JSON.parse(File.read(LIMITS))
+failures = report.filter_map do |key, objects|
+  "#{key}: #{objects} objects > #{limits[key]}" if limits[key] && objects > limits[key]
+end
+
+unless failures.empty?
+  warn "allocation regressions:\n  #{failures.join("\n  ")}"
+  exit 1
+end
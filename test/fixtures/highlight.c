@@ -0,0 +1,124 @@
+/* A syntax extension for CommonMarker.load_extension to load in the tests:
+ * ==text== is highlighted as <mark>text</mark>. */
+
+#include <parser.h>
+#include <render.h>
+#include "cmark-gfm-core-extensions.h"
+
+static cmark_node_type CMARK_NODE_HIGHLIGHT;
+
+static cmark_node *match(cmark_syntax_extension *self, cmark_parser *parser,
+                         cmark_node *parent, unsigned char character,
+                         cmark_inline_parser *inline_parser) {
+  cmark_node *res;
+  int left_flanking, right_flanking, punct_before, punct_after, delims;
+  char buffer[101];
+
+  if (character != '=')
+    return NULL;
+
+  delims = cmark_inline_parser_scan_delimiters(
+      inline_parser, sizeof(buffer) - 1, '=', &left_flanking, &right_flanking,
+      &punct_before, &punct_after);
+
+  memset(buffer, '=', delims);
+  buffer[delims] = 0;
+
+  res = cmark_node_new_with_mem(CMARK_NODE_TEXT, parser->mem);
+  cmark_node_set_literal(res, buffer);
+  res->start_line = res->end_line = cmark_inline_parser_get_line(inline_parser);
+  res->start_column = cmark_inline_parser_get_column(inline_parser) - delims;
+
+  if ((left_flanking || right_flanking) && delims == 2)
+    cmark_inline_parser_push_delimiter(inline_parser, character, left_flanking,
+                                       right_flanking, res);
+
+  return res;
+}
+
+static delimiter *insert(cmark_syntax_extension *self, cmark_parser *parser,
+                         cmark_inline_parser *inline_parser, delimiter *opener,
+                         delimiter *closer) {
+  cmark_node *highlight = opener->inl_text;
+  cmark_node *tmp, *next;
+  delimiter *delim, *tmp_delim;
+  delimiter *res = closer->next;
+
+  if (!cmark_node_set_type(highlight, CMARK_NODE_HIGHLIGHT))
+    return res;
+
+  cmark_node_set_syntax_extension(highlight, self);
+
+  tmp = cmark_node_next(opener->inl_text);
+  while (tmp && tmp != closer->inl_text) {
+    next = cmark_node_next(tmp);
+    cmark_node_append_child(highlight, tmp);
+    tmp = next;
+  }
+
+  highlight->end_column =
+      closer->inl_text->start_column + closer->inl_text->as.literal.len - 1;
+  cmark_node_free(closer->inl_text);
+
+  delim = closer;
+  while (delim != NULL && delim != opener) {
+    tmp_delim = delim->previous;
+    cmark_inline_parser_remove_delimiter(inline_parser, delim);
+    delim = tmp_delim;
+  }
+  cmark_inline_parser_remove_delimiter(inline_parser, opener);
+
+  return res;
+}
+
+static const char *get_type_string(cmark_syntax_extension *extension,
+                                   cmark_node *node) {
+  return node->type == CMARK_NODE_HIGHLIGHT ? "highlight" : "<unknown>";
+}
+
+static int can_contain(cmark_syntax_extension *extension, cmark_node *node,
+                       cmark_node_type child_type) {
+  return node->type == CMARK_NODE_HIGHLIGHT &&
+         CMARK_NODE_TYPE_INLINE_P(child_type);
+}
+
+static void commonmark_render(cmark_syntax_extension *extension,
+                              cmark_renderer *renderer, cmark_node *node,
+                              cmark_event_type ev_type, int options) {
+  renderer->out(renderer, node, "==", false, LITERAL);
+}
+
+static void html_render(cmark_syntax_extension *extension,
+                        cmark_html_renderer *renderer, cmark_node *node,
+                        cmark_event_type ev_type, int options) {
+  cmark_strbuf_puts(renderer->html,
+                    ev_type == CMARK_EVENT_ENTER ? "<mark>" : "</mark>");
+}
+
+static cmark_syntax_extension *create_highlight_extension(void) {
+  cmark_syntax_extension *ext = cmark_syntax_extension_new("highlight");
+  cmark_llist *special_chars = NULL;
+
+  cmark_syntax_extension_set_get_type_string_func(ext, get_type_string);
+  cmark_syntax_extension_set_can_contain_func(ext, can_contain);
+  cmark_syntax_extension_set_commonmark_render_func(ext, commonmark_render);
+  cmark_syntax_extension_set_html_render_func(ext, html_render);
+  CMARK_NODE_HIGHLIGHT = cmark_syntax_extension_add_node(1);
+
+  cmark_syntax_extension_set_match_inline_func(ext, match);
+  cmark_syntax_extension_set_inline_from_delim_func(ext, insert);
+
+  special_chars = cmark_llist_append(cmark_get_default_mem_allocator(),
+                                     special_chars, (void *)'=');
+  cmark_syntax_extension_set_special_inline_chars(ext, special_chars);
+  cmark_syntax_extension_set_emphasis(ext, 1);
+
+  return ext;
+}
+
+int init_highlight(cmark_plugin *plugin) {
+  cmark_plugin_register_syntax_extension(plugin, create_highlight_extension());
+  return 1;
+}
+
+int init_nothing(cmark_plugin *plugin) { return 1; }
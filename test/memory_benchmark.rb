@@ -0,0 +1,107 @@
+# frozen_string_literal: true
+
+# Measures the native memory that parsing and rendering take for a few
+# corpus profiles, through CommonMarker.memory_profile, and prints a JSON
+# report. Fails if a figure grows past its threshold in
+# test/memory_thresholds.json; UPDATE_THRESHOLDS=1 rewrites the thresholds
+# from this run, with some headroom. The thresholds are for 64-bit builds.
+#
+#   rake benchmark:memory
+
+require 'json'
+require 'commonmarker'
+
+THRESHOLDS = File.expand_path('memory_thresholds.json', __dir__)
+HEADROOM = 1.1
+MB = 1024 * 1024
+
+def repeat(target_bytes)
+  chunks = []
+  size = 0
+  index = 0
+  while size < target_bytes
+    chunk = yield(index)
+    chunks << chunk
+    size += chunk.bytesize
+    index += 1
+  end
+  chunks.join
+end
+
+PROFILES = {
+  'prose' => [[], lambda do |i|
+    "Paragraph #{i} has *some emphasis*, **strong words**, a [link](https://example.com/#{i}) " \
+      "and `inline code`, wrapped\nover a few lines of plain text that go on for a while.\n\n"
+  end],
+  'lists' => [[], lambda do |i|
+    "- item #{i}\n  - nested *item*\n    1. deeper\n    2. deeper still\n- another item\n\n"
+  end],
+  'tables' => [%i[table], lambda do |i|
+    "| name | value | note |\n|:-----|------:|:----:|\n" +
+      Array.new(20) { |row| "| row #{i}.#{row} | #{row * i} | *ok* |\n" }.join + "\n"
+  end],
+  'code' => [[], lambda do |i|
+    "```ruby\ndef method_#{i}(arg)\n  arg.map { |x| x * #{i} }\nend\n```\n\n    indented code #{i}\n\n"
+  end],
+  'references' => [[], lambda do |i|
+    "See [the docs][ref#{i}] and [more][ref#{i}].\n\n[ref#{i}]: https://example.com/docs/#{i} \"Title #{i}\"\n\n"
+  end],
+  'inline_heavy' => [%i[autolink strikethrough], lambda do |i|
+    "*a* **b** ~~c~~ `d` _e_ https://example.com/#{i} <span>f</span> \\*g\\* &amp; h  \n" * 4 + "\n"
+  end]
+}.freeze
+
+def measure(text, extensions)
+  profile = CommonMarker.memory_profile(text, :DEFAULT, extensions)
+  input_mb = text.bytesize.to_f / MB
+  parse_peak = profile[:phases].values_at(:blocks, :inlines, :postprocess).map { |phase| phase[:peak_live] }.max
+  output = profile[:output]
+
+  {
+    'input_bytes' => text.bytesize,
+    'nodes' => profile[:node_types].values.sum { |entry| entry[:count] },
+    'parse_peak_bytes' => parse_peak,
+    'parse_peak_per_input_mb' => (parse_peak / input_mb).round,
+    'retained_bytes' => profile[:retained],
+    'retained_per_input_mb' => (profile[:retained] / input_mb).round,
+    'bytes_per_node' => profile[:node_types].sort.to_h do |type, entry|
+      [type.to_s, (entry[:bytes].to_f / entry[:count]).round(1)]
+    end,
+    'output_bytes' => output[:bytes],
+    'output_overallocation' => ((output[:allocated] - output[:bytes]).to_f / output[:bytes]).round(3)
+  }
+end
+
+CHECKED = %w[parse_peak_per_input_mb retained_per_input_mb output_overallocation].freeze
+
+size = Integer(ENV.fetch('CORPUS_BYTES', MB.to_s))
+report = PROFILES.to_h do |name, (extensions, generator)|
+  [name, measure(repeat(size, &generator), extensions)]
+end
+
+puts JSON.pretty_generate(report)
+
+if ENV['UPDATE_THRESHOLDS']
+  thresholds = report.transform_values do |figures|
+    CHECKED.to_h do |key|
+      limit = figures[key] * HEADROOM
+      [key, figures[key].is_a?(Integer) ? limit.ceil : limit.round(3)]
+    end
+  end
+  File.write(THRESHOLDS, "#{JSON.pretty_generate(thresholds)}\n")
+  warn "wrote #{THRESHOLDS}"
+  exit
+end
+
+thresholds = JSON.parse(File.read(THRESHOLDS))
+failures = report.flat_map do |name, figures|
+  CHECKED.filter_map do |key|
+    limit = thresholds.dig(name, key)
+    "#{name} #{key}: #{figures[key]} > #{limit}" if limit && figures[key] > limit
+  end
+end
+
+unless failures.empty?
+  warn "memory regressions:\n  #{failures.join("\n  ")}"
+  exit 1
+end
@@ -0,0 +1,67 @@
+# frozen_string_literal: true
+
+# Measures render and traversal throughput on a large document, as parsed
+# and after render_doc(compact: true) has copied it into one block of
+# memory in document order. Set CORPUS_BYTES to change the document size.
+#
+#   rake benchmark:render
+
+require 'commonmarker'
+
+EXTENSIONS = %i[table strikethrough autolink tagfilter tasklist].freeze
+SAMPLE = <<~MARKDOWN
+  ## Section
+
+  A paragraph with *emphasis*, **strong text**, `code`, ~~struck~~ words and
+  a [link](https://example.com/page "title"), wrapped over a few lines so that
+  it has soft breaks, then https://example.org as an autolink.
+
+  - [x] a task
+  - [ ] another task
+    - nested *item*
+
+  | name | value |
+  |------|------:|
+  | one  | 1     |
+  | two  | *2*   |
+
+  ```ruby
+  puts 'code block'
+  ```
+
+  > A quote with a [reference][ref].
+
+  [ref]: https://example.com/ref
+
+MARKDOWN
+
+size = Integer(ENV.fetch('CORPUS_BYTES', (4 * 1024 * 1024).to_s))
+text = SAMPLE * ((size / SAMPLE.bytesize) + 1)
+
+RENDERS = {
+  'to_html' => ->(doc) { doc.to_html(:DEFAULT, EXTENSIONS) },
+  'to_commonmark' => ->(doc) { doc.to_commonmark },
+  'walk' => ->(doc) { doc.walk { |node| node } }
+}.freeze
+
+# Returns the best of a few runs, in seconds.
+def best_time(doc, render)
+  render.call(doc)
+  Array.new(5) do
+    started = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    render.call(doc)
+    Process.clock_gettime(Process::CLOCK_MONOTONIC) - started
+  end.min
+end
+
+docs = {
+  'as parsed' => CommonMarker.render_doc(text, :DEFAULT, EXTENSIONS),
+  'compacted' => CommonMarker.render_doc(text, :DEFAULT, EXTENSIONS, compact: true)
+}
+
+mb = text.bytesize.to_f / (1024 * 1024)
+printf("%-14s %12s %12s %8s\n", 'render', 'as parsed', 'compacted', 'speedup')
+RENDERS.each do |name, render|
+  parsed, compacted = docs.values.map { |doc| best_time(doc, render) }
+  printf("%-14s %7.1f MB/s %7.1f MB/s %7.2fx\n", name, mb / parsed, mb / compacted, parsed / compacted)
+end
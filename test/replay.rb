@@ -0,0 +1,29 @@
+# frozen_string_literal: true
+
+# Renders the inputs in a file written by CommonMarker.dump_slow_inputs
+# again, best of RUNS times each, to see whether their latency reproduces:
+#
+#   rake replay[slow_inputs.jsonl]
+
+require 'benchmark'
+require 'json'
+require 'commonmarker'
+
+runs = Integer(ENV.fetch('RUNS', '5'))
+
+File.foreach(ENV.fetch('SLOW_INPUTS')) do |line|
+  input = JSON.parse(line, symbolize_names: true)
+  text = input[:input].freeze
+  extensions = input[:extensions].map(&:to_sym)
+
+  replayed = Array.new(runs) do
+    Benchmark.realtime { CommonMarker::Node.markdown_to_html(text, input[:options], extensions) }
+  end.min
+
+  printf("%<digest>s %<bytes>9d bytes%<truncated>s  recorded %<recorded>9.2f ms%<timed_out>s  replayed %<replayed>9.2f ms\n",
+         digest: input[:digest], bytes: input[:input_bytes],
+         truncated: input[:truncated] ? " (#{text.bytesize} kept)" : '',
+         recorded: (input[:parse_ns].to_i + input[:render_ns].to_i) / 1e6,
+         timed_out: input[:timed_out] ? ' (timed out)' : '',
+         replayed: replayed * 1000)
+end
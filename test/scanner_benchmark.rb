@@ -0,0 +1,115 @@
+# frozen_string_literal: true
+
+# Measures parse throughput on corpora that lean on the re2c scanners: HTML
+# blocks and tags, autolinks, entities, fences and headings, link reference
+# definitions, and the table and tasklist scanners. Set CORPUS_BYTES to
+# change the size of each corpus.
+#
+# To compare two builds, save the figures from one and check the other
+# against them; it fails if a corpus got more than TOLERANCE (default 5%)
+# slower:
+#
+#   RESULTS=before.json rake benchmark:scanners
+#   BASELINE=before.json rake benchmark:scanners
+
+require 'commonmarker'
+require 'json'
+
+EXTENSIONS = %i[table tasklist autolink].freeze
+
+SAMPLES = {
+  'html_blocks' => <<~MARKDOWN,
+    <div class="note" data-id='1'>
+    <p>A block of <em>raw</em> HTML.</p>
+    </div>
+
+    <!-- a comment
+    over two lines -->
+
+    <?php echo 'processing'; ?>
+
+    <table><tr><td>cell</td></tr></table>
+
+  MARKDOWN
+  'inline_html' => <<~MARKDOWN,
+    Text with <span class="a" data-x='y'>inline</span> <b>tags</b>, <br/> breaks,
+    <a href="/x" title="t">links</a> and <!-- comments --> in a paragraph.
+
+  MARKDOWN
+  'autolinks' => <<~MARKDOWN,
+    See <https://example.com/path?q=1&r=2>, <mailto:someone@example.com>,
+    <user.name+tag@example.co.uk> and <irc://irc.example.net/channel>.
+
+  MARKDOWN
+  'entities' => <<~MARKDOWN,
+    &amp; &copy; &#169; &#xA9; &nbsp; &lt;tag&gt; &ThickSpace; &hearts; &#x1F600;
+
+  MARKDOWN
+  'fences_headings' => <<~MARKDOWN,
+    # Heading
+
+    ```ruby
+    puts 'code'
+    ```
+
+    Setext heading
+    ==============
+
+    ~~~
+    more code
+    ~~~
+
+  MARKDOWN
+  'link_references' => <<~MARKDOWN,
+    [ref]: https://example.com/page "A title"
+    [other]: </with spaces> 'Another title'
+
+    [a][ref], [b][other] and [c](/url (parenthesised title)).
+
+  MARKDOWN
+  'tables_tasks' => <<~MARKDOWN
+    | name | value |
+    |:-----|------:|
+    | one  | 1     |
+    | two  | `2`   |
+
+    - [x] done
+    - [ ] to do
+
+  MARKDOWN
+}.freeze
+
+size = Integer(ENV.fetch('CORPUS_BYTES', (1024 * 1024).to_s))
+tolerance = Float(ENV.fetch('TOLERANCE', '0.05'))
+
+# Returns the best of many parses of 'text', in seconds of CPU time, which
+# other processes on a busy machine disturb less than the wall clock.
+def best_time(text)
+  CommonMarker.render_doc(text, :UNSAFE, EXTENSIONS)
+  Array.new(30) do
+    started = Process.clock_gettime(Process::CLOCK_PROCESS_CPUTIME_ID)
+    CommonMarker.render_doc(text, :UNSAFE, EXTENSIONS)
+    Process.clock_gettime(Process::CLOCK_PROCESS_CPUTIME_ID) - started
+  end.min
+end
+
+results = SAMPLES.to_h do |name, sample|
+  text = sample * ((size / sample.bytesize) + 1)
+  [name, (text.bytesize.to_f / (1024 * 1024) / best_time(text)).round(1)]
+end
+
+baseline = ENV['BASELINE'] && JSON.parse(File.read(ENV['BASELINE']))
+slower = []
+
+printf("%-16s %12s %12s\n", 'corpus', 'MB/s', baseline ? 'baseline' : '')
+results.each do |name, rate|
+  if baseline && baseline[name]
+    printf("%-16s %12.1f %12.1f\n", name, rate, baseline[name])
+    slower << name if rate < baseline[name] * (1 - tolerance)
+  else
+    printf("%-16s %12.1f\n", name, rate)
+  end
+end
+
+File.write(ENV['RESULTS'], "#{JSON.pretty_generate(results)}\n") if ENV['RESULTS']
+abort "Slower than the baseline: #{slower.join(', ')}" unless slower.empty?
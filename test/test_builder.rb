@@ -0,0 +1,104 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'commonmarker/builder'
+require 'tmpdir'
+
+class TestBuilder < Minitest::Test
+  def setup
+    @dir = Dir.mktmpdir
+    @source = File.join(@dir, 'src')
+    @output = File.join(@dir, 'out')
+    write('index.md', "# Home\n")
+    write('guide/intro.markdown', "| a |\n|---|\n| b |\n")
+    20.times { |i| write("pages/#{i}.md", "Page *#{i}*\n") }
+    write('notes.txt', 'not markdown')
+    FileUtils.mkdir_p(File.join(@source, 'folder.md'))
+  end
+
+  def teardown
+    FileUtils.remove_entry(@dir)
+  end
+
+  def write(path, text)
+    FileUtils.mkdir_p(File.dirname(File.join(@source, path)))
+    File.write(File.join(@source, path), text)
+  end
+
+  def build(**options)
+    CommonMarker::Builder.new(@source, @output, jobs: 4, **options).run
+  end
+
+  def test_mirrors_the_tree
+    result = build(extensions: %i[table])
+
+    assert_equal 22, result.built
+    assert_equal "<h1>Home</h1>\n", File.read(File.join(@output, 'index.html'))
+    assert_includes File.read(File.join(@output, 'guide/intro.html')), '<table>'
+    assert_equal "<p>Page <em>7</em></p>\n", File.read(File.join(@output, 'pages/7.html'))
+    refute File.exist?(File.join(@output, 'notes.html'))
+  end
+
+  def test_rebuilds_only_what_changed
+    build
+    write('pages/3.md', "Changed\n")
+    FileUtils.rm(File.join(@output, 'pages/4.html'))
+    FileUtils.rm(File.join(@source, 'pages/5.md'))
+
+    result = build
+    assert_equal 2, result.built
+    assert_equal 19, result.unchanged
+    assert_equal 1, result.removed
+    assert_equal "<p>Changed</p>\n", File.read(File.join(@output, 'pages/3.html'))
+    assert File.exist?(File.join(@output, 'pages/4.html'))
+    refute File.exist?(File.join(@output, 'pages/5.html'))
+  end
+
+  def test_changing_options_rebuilds_everything
+    build
+    assert_equal 22, build(render_options: :HARDBREAKS).built
+    assert_equal 22, build(render_options: :HARDBREAKS, format: :plaintext).built
+    assert File.exist?(File.join(@output, 'index.txt'))
+  end
+
+  def test_one_job
+    assert_equal 22, build(jobs: 1).built
+    assert_equal 22, build(jobs: 1).unchanged
+  end
+
+  def test_workers_reporting_more_than_a_pipe_holds
+    dir = "#{'d' * 200}/#{'e' * 200}"
+    400.times { |i| write("#{dir}/#{i}.md", "#{i}\n") }
+
+    result = build(jobs: 2)
+    assert_equal 422, result.built
+    assert_equal "<p>399</p>\n", File.read(File.join(@output, dir, '399.html'))
+  end
+
+  def test_failures_are_retried_next_time
+    result = nil
+    _out, err = capture_subprocess_io do
+      CommonMarker.stub(:render_doc, ->(*) { raise 'boom' }) { result = build }
+    end
+    assert_equal 22, result.failed
+    assert_match 'index.md: boom', err
+    assert_equal 22, build.built
+  end
+
+  def test_rejects_bad_options
+    assert_raises(TypeError) { build(parse_options: :BOGUS) }
+    assert_raises(ArgumentError) { build(format: :pdf) }
+    assert_raises(ArgumentError) { build(jobs: 0) }
+  end
+
+  def test_reports_throughput
+    assert_match(/22 built, 0 unchanged, 0 removed, 0 failed in [\d.]+s \([\d.]+ files\/s/, build.to_s)
+  end
+
+  def test_command
+    `ruby bin/commonmarker build --extension=table -j 2 #{@source} #{@output} 2>&1`
+    assert_predicate $?, :success? # rubocop:disable Style/SpecialGlobalVars
+    assert_includes File.read(File.join(@output, 'guide/intro.html')), '<table>'
+    assert_match '22 unchanged', `ruby bin/commonmarker build --extension=table #{@source} #{@output} 2>&1`
+  end
+end
@@ -0,0 +1,83 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestCompact < Minitest::Test
+  EXTENSIONS = %i[table strikethrough autolink tagfilter tasklist].freeze
+
+  MARKDOWN = <<~MD
+    # Heading with `code`
+
+    Some *emphasis*, **strong**, ~~struck~~ and a [link](https://example.com "title"),
+    an ![image](img.png) and www.example.org.[^note]
+
+    | a | b |
+    |---|:-:|
+    | 1 | *2* |
+
+    - [x] done
+    - [ ] todo
+
+    ```ruby
+    puts 'hi'
+    ```
+
+    <div>html</div>
+
+    [^note]: A footnote with **bold** text.
+  MD
+
+  def render(compact)
+    CommonMarker.render_doc(MARKDOWN, %i[DEFAULT FOOTNOTES], EXTENSIONS, compact: compact)
+  end
+
+  def test_renders_the_same
+    plain = render(false)
+    compact = render(true)
+
+    assert_equal plain.to_html(:DEFAULT, EXTENSIONS), compact.to_html(:DEFAULT, EXTENSIONS)
+    assert_equal plain.to_commonmark, compact.to_commonmark
+    assert_equal plain.to_xml, compact.to_xml
+    assert_equal plain.to_plaintext, compact.to_plaintext
+  end
+
+  def test_walks_the_same
+    describe = lambda do |doc|
+      nodes = []
+      doc.walk do |node|
+        nodes << [node.type, node.sourcepos, node.type == :text ? node.string_content : nil]
+      end
+      nodes
+    end
+
+    assert_equal describe.call(render(false)), describe.call(render(true))
+  end
+
+  def test_can_be_modified
+    doc = render(true)
+    link = doc.walk.find { |node| node.type == :link }
+    link.url = 'https://example.net'
+    link.first_child.string_content = 'changed'
+    heading = doc.first_child
+    heading.delete
+    doc.append_child(heading)
+    doc.walk.select { |node| node.type == :strikethrough }.each(&:delete)
+    GC.start
+
+    html = doc.to_html(:DEFAULT, EXTENSIONS)
+    assert_includes html, '<a href="https://example.net" title="title">changed</a>'
+    refute_includes html, '<del>'
+    assert_match %r{<h1>Heading with <code>code</code></h1>\n\z}, html
+  end
+
+  def test_detached_nodes_outlive_the_document
+    doc = render(true)
+    paragraph = doc.first_child.next
+    paragraph.delete
+    doc = nil # rubocop:disable Lint/UselessAssignment
+    GC.start
+
+    assert_equal 'emphasis', paragraph.first_child.next.first_child.string_content
+    assert_match(/\*emphasis\*/, paragraph.to_commonmark)
+  end
+end
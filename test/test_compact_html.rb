@@ -0,0 +1,84 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'rexml/document'
+
+class TestCompactHtml < Minitest::Test
+  BLOCK_ELEMENTS = %w[root blockquote div h1 h2 h3 h4 h5 h6 hr li ol p pre section table tbody td th thead tr ul].freeze
+
+  # Normalizes an HTML fragment to nested arrays, dropping whitespace that
+  # only separates block elements. Text inside <pre> is kept as it is.
+  def self.dom(html)
+    html = html.gsub(/ (data-[a-z-]+)(?=[ >])/, ' \1=""')
+    normalize(REXML::Document.new("<root>#{html}</root>").root, false)
+  end
+
+  def self.normalize(element, in_pre)
+    in_pre ||= element.name == 'pre'
+    children = element.children.each_with_index.map do |child, index|
+      case child
+      when REXML::Element then normalize(child, in_pre)
+      when REXML::Text then normalize_text(child.value, element.children, index, in_pre)
+      else child.to_s
+      end
+    end
+    [element.name, element.attributes.to_h.sort, children.compact]
+  end
+
+  def self.normalize_text(text, siblings, index, in_pre)
+    unless in_pre
+      text = text.sub(/\A\s+/, '') if block_boundary?(index.zero? ? nil : siblings[index - 1])
+      text = text.sub(/\s+\z/, '') if block_boundary?(siblings[index + 1])
+    end
+    text.empty? ? nil : text
+  end
+
+  def self.block_boundary?(sibling)
+    sibling.nil? || (sibling.is_a?(REXML::Element) && BLOCK_ELEMENTS.include?(sibling.name))
+  end
+
+  def assert_equivalent(markdown, extensions = [], options = :DEFAULT)
+    doc = CommonMarker.render_doc(markdown, options, extensions)
+    normal = doc.to_html(options, extensions)
+    compact = doc.to_html(Array(options) + [:COMPACT_HTML], extensions)
+
+    assert_operator compact.count("\n"), :<=, normal.count("\n")
+    assert_equal self.class.dom(normal), self.class.dom(compact), markdown
+  end
+
+  def test_drops_newlines_between_blocks
+    html = CommonMarker.render_html("# Hi\n\n> a\n> b\n\n- x\n\n- y\n\n***", :COMPACT_HTML)
+    assert_equal '<h1>Hi</h1><blockquote><p>a' + "\n" + 'b</p></blockquote><ul><li><p>x</p></li><li><p>y</p></li></ul><hr />', html
+  end
+
+  def test_keeps_code_and_raw_html
+    html = CommonMarker.render_html("```\na\n\nb\n```\n<div>\n  x\n</div>\n\n    c\n", %i[COMPACT_HTML UNSAFE])
+    assert_equal "<pre><code>a\n\nb\n</code></pre><div>\n  x\n</div>\n<pre><code>c\n</code></pre>", html
+  end
+
+  def test_fixtures
+    %w[curly.md dingus.md strong.md table.md].each do |fixture|
+      assert_equivalent(fixtures_file(fixture), %i[table strikethrough autolink tasklist])
+    end
+  end
+
+  def test_extensions
+    markdown = "| a | b |\n|---|:-:|\n| `c` | *d* |\n\n- [x] done\n- [ ] todo\n\n~~old~~ https://example.com\n\n$$\nx\n\ny\n$$\n"
+    assert_equivalent(markdown, %i[table tasklist strikethrough autolink math])
+  end
+
+  def test_footnotes
+    assert_equivalent("Hi[^1] and[^2].\n\n[^1]: One\n\n[^2]:\n    Two\n\n    > Three\n", [], :FOOTNOTES)
+  end
+
+  spec_file = File.join('ext', 'commonmarker', 'cmark-upstream', 'test', 'spec.txt')
+  if File.exist?(spec_file)
+    open_spec_file('spec.txt').each do |testcase|
+      next if testcase[:extensions].include?(:disabled)
+
+      define_method("test_spec_example_#{testcase[:example]}") do
+        assert_equivalent(testcase[:markdown], testcase[:extensions])
+      end
+    end
+  end
+end
@@ -0,0 +1,46 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'zlib'
+
+class TestCompression < Minitest::Test
+  def setup
+    @doc = CommonMarker.render_doc(fixtures_file('dingus.md') * 200, :DEFAULT, %i[table])
+    @html = @doc.to_html(:DEFAULT, %i[table])
+  end
+
+  def test_deflate
+    compressed = @doc.to_html(:DEFAULT, %i[table], compress: :deflate)
+    assert_equal Encoding::BINARY, compressed.encoding
+    assert_operator compressed.bytesize, :<, @html.bytesize
+    assert_equal @html, Zlib::Inflate.inflate(compressed).force_encoding('utf-8')
+  end
+
+  def test_gzip
+    compressed = @doc.to_html(:DEFAULT, %i[table], compress: :gzip, level: 9)
+    assert_equal @html, Zlib.gunzip(compressed).force_encoding('utf-8')
+  end
+
+  def test_options_apply
+    compressed = @doc.to_html(%i[COMPACT_HTML], %i[table], compress: :deflate, level: 1)
+    assert_equal @doc.to_html(%i[COMPACT_HTML], %i[table]), Zlib::Inflate.inflate(compressed).force_encoding('utf-8')
+  end
+
+  def test_output_larger_than_the_buffer
+    doc = CommonMarker.render_doc(Array.new(20_000) { |i| "Paragraph #{i * 7919}\n\n" }.join)
+    compressed = doc.to_html(compress: :gzip, level: 0)
+    assert_operator compressed.bytesize, :>, 256 * 1024
+    assert_equal doc.to_html, Zlib.gunzip(compressed).force_encoding('utf-8')
+  end
+
+  def test_small_and_empty_documents
+    [CommonMarker.render_doc(''), CommonMarker.render_doc("Hi[^1]\n\n[^1]: There", :FOOTNOTES)].each do |doc|
+      assert_equal doc.to_html, Zlib::Inflate.inflate(doc.to_html(compress: :deflate)).force_encoding('utf-8')
+    end
+  end
+
+  def test_bad_arguments
+    assert_raises(ArgumentError) { @doc.to_html(compress: :brotli) }
+    assert_raises(ArgumentError) { @doc.to_html(compress: :gzip, level: 10) }
+  end
+end
@@ -0,0 +1,60 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+# Forked workers share the extension's writable pages with their parent
+# until one of them writes there. Rendering should never do so, or each
+# worker ends up with its own copy of those pages.
+class TestCopyOnWrite < Minitest::Test
+  EXTENSIONS = %i[table strikethrough autolink tagfilter tasklist].freeze
+
+  # Sums Private_Dirty over the mappings of the extension.
+  def private_dirty_kb
+    library = $LOADED_FEATURES.grep(%r{commonmarker/commonmarker\.(so|bundle)\z}).first
+    total = 0
+    counting = false
+    File.foreach('/proc/self/smaps') do |line|
+      if line =~ /\A\h+-\h+ /
+        counting = line.rstrip.end_with?(" #{library}")
+      elsif counting && line.start_with?('Private_Dirty:')
+        total += line.split[1].to_i
+      end
+    end
+    total
+  end
+
+  def render_everything(text)
+    doc = CommonMarker.render_doc(text, %i[DEFAULT FOOTNOTES], EXTENSIONS)
+    doc.to_html(:DEFAULT, EXTENSIONS)
+    doc.to_html(:DEFAULT, EXTENSIONS, compress: :gzip)
+    doc.to_commonmark
+    doc.to_xml
+    doc.to_plaintext
+    doc.walk { |node| [node.type, node.sourcepos, node.type == :text && node.string_content] }
+    doc.tables
+    CommonMarker.render_html(text, :DEFAULT, EXTENSIONS)
+    CommonMarker.render_html(text, %i[SMART UNSAFE])
+    CommonMarker.render_doc(text, :DEFAULT, [], compact: true).to_html
+    CommonMarker.tasklist_summary(text)
+  end
+
+  def test_rendering_leaves_shared_pages_alone
+    skip 'needs fork and /proc/self/smaps' unless Process.respond_to?(:fork) && File.exist?('/proc/self/smaps')
+
+    text = fixtures_file('dingus.md') + fixtures_file('table.md') + "- [x] done\n\n[^1]: note\n"
+    reader, writer = IO.pipe
+    pid = fork do
+      reader.close
+      before = private_dirty_kb
+      2.times { render_everything(text) }
+      writer.puts(private_dirty_kb - before)
+      exit!(0)
+    end
+    writer.close
+    delta = reader.read
+    _, status = Process.wait2(pid)
+
+    assert_predicate status, :success?
+    assert_equal "0\n", delta, 'rendering in a forked child wrote to pages shared with the parent'
+  end
+end
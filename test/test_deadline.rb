@@ -0,0 +1,85 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestDeadline < Minitest::Test
+  def now
+    Process.clock_gettime(Process::CLOCK_MONOTONIC, :nanosecond)
+  end
+
+  def setup
+    @text = fixtures_file('dingus.md') * 200
+  end
+
+  def test_generous_deadlines_change_nothing
+    deadline = now + 60 * 1_000_000_000
+    html = CommonMarker.render_html(@text, :DEFAULT, %i[table])
+    assert_equal html, CommonMarker.render_html(@text, :DEFAULT, %i[table], deadline: deadline)
+
+    doc = CommonMarker.render_doc(@text, :DEFAULT, %i[table], deadline: deadline)
+    assert_equal html, doc.to_html(:DEFAULT, %i[table], deadline: deadline)
+  end
+
+  def test_parsing_past_the_deadline
+    assert_raises(CommonMarker::Timeout) { CommonMarker.render_doc(@text, :DEFAULT, [], deadline: now - 1) }
+    assert_raises(CommonMarker::Timeout) { CommonMarker.render_html(@text, :DEFAULT, [], deadline: now - 1) }
+  end
+
+  def test_inline_parsing_is_interrupted
+    text = "#{'*a **a ' * 100_000}b"
+    assert_raises(CommonMarker::Timeout) { CommonMarker.render_doc(text, :DEFAULT, [], deadline: now + 1_000) }
+  end
+
+  def test_rendering_past_the_deadline
+    doc = CommonMarker.render_doc(@text)
+    assert_raises(CommonMarker::Timeout) { doc.to_html(deadline: now - 1) }
+  end
+
+  def test_compressing_past_the_deadline
+    doc = CommonMarker.render_doc(@text)
+    assert_raises(CommonMarker::Timeout) { doc.to_html(compress: :gzip, deadline: now - 1) }
+  rescue NotImplementedError
+    skip 'built without zlib'
+  end
+
+  def test_timeout_is_a_timeout_error
+    assert_operator CommonMarker::Timeout, :<, ::Timeout::Error
+  end
+
+  def test_pathological_input_stops_promptly
+    text = '[' * 50_000 + 'a' + ']' * 50_000 + "\n> " * 20_000
+    started = now
+    assert_raises(CommonMarker::Timeout) do
+      CommonMarker.render_html(text * 20, :DEFAULT, %i[table], deadline: started + 5_000_000)
+    end
+    assert_operator now - started, :<, 1_000_000_000
+  end
+
+  def test_interrupting_a_render_without_the_gvl
+    text = @text * 100
+    started = now
+    CommonMarker::Node.markdown_to_html(text, 0, [], nil, true)
+    uninterrupted = now - started
+
+    thread = Thread.new { CommonMarker::Node.markdown_to_html(text, 0, [], nil, true) }
+    thread.report_on_exception = false
+    sleep 0.01
+    started = now
+    thread.raise(Interrupt)
+    assert_raises(Interrupt) { thread.join }
+    assert_operator now - started, :<, uninterrupted / 2
+    assert_equal "<p>Hi</p>\n", CommonMarker::Node.markdown_to_html('Hi', 0, [], nil, true)
+  end
+
+  def test_wakeups_do_not_cut_a_render_without_the_gvl_short
+    text = @text * 10
+    thread = Thread.new { CommonMarker::Node.markdown_to_html(text, 0, [], nil, true) }
+    5.times do
+      sleep 0.001
+      thread.wakeup
+    rescue ThreadError # already finished
+      break
+    end
+    assert_equal CommonMarker.render_html(text), thread.value
+  end
+end
@@ -0,0 +1,62 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestEachChunk < Minitest::Test
+  def setup
+    @doc = CommonMarker.render_doc(fixtures_file('dingus.md') * 50 + "Hi[^1] ünïcödé\n\n[^1]: There\n", :FOOTNOTES, %i[table])
+  end
+
+  def test_chunks_add_up_to_the_html
+    [1, 7, 1000].each do |nodes|
+      [1, 100, 16 * 1024].each do |bytes|
+        chunks = @doc.each_chunk(:DEFAULT, %i[table], nodes: nodes, bytes: bytes).to_a
+        assert_equal @doc.to_html(:DEFAULT, %i[table]), chunks.join
+      end
+    end
+  end
+
+  def test_chunks_are_bounded
+    chunks = @doc.each_chunk(nodes: 10).to_a
+    assert_operator chunks.length, :>, 10
+    assert(chunks.all? { |chunk| chunk.encoding == Encoding::UTF_8 && chunk.valid_encoding? })
+    refute(chunks.any?(&:empty?))
+  end
+
+  def test_options_and_attributes_apply
+    attributes = CommonMarker::HtmlAttributes.new(paragraph: { class: 'p' })
+    options = %i[COMPACT_HTML FOOTNOTES]
+    assert_equal @doc.to_html(options, %i[table], attributes: attributes),
+                 @doc.each_chunk(options, %i[table], attributes: attributes, nodes: 3).to_a.join
+  end
+
+  def test_external_enumeration_can_stop_early
+    enum = @doc.each_chunk(nodes: 1)
+    first = enum.next
+    assert @doc.to_html.start_with?(first)
+    enum.rewind
+    assert_equal first, enum.next
+  end
+
+  def test_dropped_enumerations_are_collected
+    html = @doc.to_html
+    10.times { @doc.each_chunk(nodes: 1).next }
+    GC.start
+    assert_equal html, @doc.each_chunk(nodes: 1).to_a.join
+  end
+
+  def test_breaking_out_of_the_block
+    count = 0
+    @doc.each_chunk(nodes: 1) { |_| break if (count += 1) == 3 }
+    assert_equal 3, count
+  end
+
+  def test_empty_document
+    assert_equal [], CommonMarker.render_doc('').each_chunk.to_a
+  end
+
+  def test_rejects_bad_limits
+    assert_raises(ArgumentError) { @doc.each_chunk(nodes: 0).to_a }
+    assert_raises(ArgumentError) { @doc.each_chunk(bytes: -1).to_a }
+  end
+end
@@ -0,0 +1,31 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestEmoji < Minitest::Test
+  def test_replaces_shortcodes
+    html = CommonMarker.render_html(':tada: Shipped :+1::rocket: *:smile:*', :DEFAULT, %i[emoji])
+    assert_equal "<p>🎉 Shipped 👍🚀 <em>😄</em></p>\n", html
+  end
+
+  def test_leaves_unknown_and_malformed_shortcodes
+    html = CommonMarker.render_html(':not_an_emoji: :smile :Smile: : smile: a:nope:c', :DEFAULT, %i[emoji])
+    assert_equal "<p>:not_an_emoji: :smile :Smile: : smile: a:nope:c</p>\n", html
+  end
+
+  def test_ignores_code
+    html = CommonMarker.render_html("`:tada:`\n\n    :tada:\n", :DEFAULT, %i[emoji])
+    assert_equal "<p><code>:tada:</code></p>\n<pre><code>:tada:\n</code></pre>\n", html
+  end
+
+  def test_emits_text_nodes
+    doc = CommonMarker.render_doc('Hi :wave:', :DEFAULT, %i[emoji])
+    assert_equal [:text], doc.first_child.map(&:type)
+    assert_equal 'Hi 👋', doc.first_child.first_child.string_content
+  end
+
+  def test_works_with_autolink
+    html = CommonMarker.render_html(':link: https://github.com', :DEFAULT, %i[emoji autolink])
+    assert_equal "<p>🔗 <a href=\"https://github.com\">https://github.com</a></p>\n", html
+  end
+end
@@ -0,0 +1,87 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestHtmlAttributes < Minitest::Test
+  ATTRIBUTES = CommonMarker::HtmlAttributes.new(
+    table: { class: 'table' },
+    image: { loading: 'lazy' },
+    link: { class: 'link' },
+    external_link: { rel: 'nofollow', target: '_blank' },
+    code: { class: 'code' },
+    header: { class: 'title' },
+    code_language_prefix: 'highlight-'
+  )
+
+  def test_is_frozen
+    assert_predicate ATTRIBUTES, :frozen?
+    assert_predicate ATTRIBUTES.native, :frozen?
+  end
+
+  def test_adds_attributes
+    md = <<~MD
+      # Title
+
+      [in](/docs) [out](https://example.com) [proto](//example.com) [mail](mailto:a@b.c) ![img](a.png "T") `x`
+
+      ```ruby
+      1
+      ```
+
+      | a |
+      |---|
+      | b |
+    MD
+    html = CommonMarker.render_html(md, :DEFAULT, %i[table], attributes: ATTRIBUTES)
+    assert_equal <<~HTML, html
+      <h1 class="title">Title</h1>
+      <p><a href="/docs" class="link">in</a> <a href="https://example.com" class="link" rel="nofollow" target="_blank">out</a> <a href="//example.com" class="link" rel="nofollow" target="_blank">proto</a> <a href="mailto:a@b.c" class="link">mail</a> <img src="a.png" alt="img" title="T" loading="lazy" /> <code class="code">x</code></p>
+      <pre><code class="highlight-ruby">1
+      </code></pre>
+      <table class="table">
+      <thead>
+      <tr>
+      <th>a</th>
+      </tr>
+      </thead>
+      <tbody>
+      <tr>
+      <td>b</td>
+      </tr>
+      </tbody>
+      </table>
+    HTML
+  end
+
+  def test_adds_attributes_to_extension_elements
+    attributes = CommonMarker::HtmlAttributes.new(
+      strikethrough: { class: 'struck' },
+      task_item: { class: 'task' },
+      link: { class: 'link' },
+      external_link: { rel: 'nofollow' }
+    )
+    md = "- [x] ~~done~~ at https://example.com\n"
+    html = CommonMarker.render_html(md, :DEFAULT, %i[strikethrough tasklist autolink], attributes: attributes)
+    assert_equal <<~HTML, html
+      <ul>
+      <li class="task"><input type="checkbox" checked="" disabled="" /> <del class="struck">done</del> at <a href="https://example.com" class="link" rel="nofollow">https://example.com</a></li>
+      </ul>
+    HTML
+  end
+
+  def test_escapes_values
+    attributes = CommonMarker::HtmlAttributes.new(paragraph: { 'data-x': '"<&>"' })
+    assert_equal "<p data-x=\"&quot;&lt;&amp;&gt;&quot;\">hi</p>\n", CommonMarker.render_doc('hi').to_html(attributes: attributes)
+  end
+
+  def test_without_attributes
+    md = "[out](https://example.com)\n"
+    assert_equal CommonMarker.render_html(md), CommonMarker.render_doc(md).to_html(attributes: CommonMarker::HtmlAttributes.new)
+  end
+
+  def test_rejects_bad_input
+    assert_raises(TypeError) { CommonMarker::HtmlAttributes.new(tabel: { class: 'x' }) }
+    assert_raises(TypeError) { CommonMarker::HtmlAttributes.new(table: 'class="x"') }
+    assert_raises(TypeError) { CommonMarker::HtmlAttributes.new(table: { 'on click' => 'x' }) }
+  end
+end
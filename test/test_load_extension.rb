@@ -0,0 +1,64 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'rbconfig'
+require 'tmpdir'
+
+class TestLoadExtension < Minitest::Test
+  SOURCE = File.join(FIXTURES_DIR, 'highlight.c')
+  HEADERS = File.expand_path('../ext/commonmarker', __dir__)
+
+  # Builds test/fixtures/highlight.c once, and loads it into the process;
+  # extensions can't be unloaded.
+  def self.plugin
+    @plugin ||= begin
+      dir = Dir.mktmpdir
+      path = File.join(dir, "highlight.#{RbConfig::CONFIG['DLEXT']}")
+      link = RbConfig::CONFIG['host_os'].include?('darwin') ? '-bundle -undefined dynamic_lookup' : '-shared'
+      system("#{RbConfig::CONFIG['CC']} -std=c99 -fPIC #{link} -I#{HEADERS} -o #{path} #{SOURCE}") ? path : false
+    end
+  end
+
+  def setup
+    skip 'needs a C compiler' unless self.class.plugin
+    CommonMarker.load_extension(self.class.plugin) unless CommonMarker.extensions.include?('highlight')
+  rescue NotImplementedError
+    skip 'built without dlopen'
+  end
+
+  def test_extension_is_usable_by_name
+    assert_includes CommonMarker.extensions, 'highlight'
+    assert_equal "<p>a <mark>b <em>c</em></mark> d</p>\n",
+                 CommonMarker.render_html('a ==b *c*== d', :DEFAULT, %i[highlight])
+  end
+
+  def test_extension_works_with_the_node_api
+    doc = CommonMarker.render_doc('==marked==', :DEFAULT, %i[highlight table])
+    node = doc.first_child.first_child
+    assert_equal :highlight, node.type
+    assert_equal 'marked', node.first_child.string_content
+    assert_equal "==marked==\n", doc.to_commonmark
+  end
+
+  def test_without_the_extension_nothing_changes
+    assert_equal "<p>a ==b== d</p>\n", CommonMarker.render_html('a ==b== d')
+  end
+
+  def test_loading_again_is_refused
+    error = assert_raises(ArgumentError) { CommonMarker.load_extension(self.class.plugin) }
+    assert_match(/highlight is already registered/, error.message)
+  end
+
+  def test_missing_init_function
+    assert_raises(LoadError) { CommonMarker.load_extension(self.class.plugin, init: 'init_missing') }
+  end
+
+  def test_init_function_that_registers_nothing
+    error = assert_raises(LoadError) { CommonMarker.load_extension(self.class.plugin, init: 'init_nothing') }
+    assert_match(/registered no extensions/, error.message)
+  end
+
+  def test_missing_file
+    assert_raises(LoadError) { CommonMarker.load_extension('/nonexistent/highlight.so') }
+  end
+end
@@ -0,0 +1,68 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestMath < Minitest::Test
+  def test_inline_and_display_spans
+    html = CommonMarker.render_html('Euler: $e^{i\pi} + 1 = 0$ and $$\sum_i x_i$$.', :DEFAULT, %i[math])
+    assert_equal "<p>Euler: <span data-math-style=\"inline\">e^{i\\pi} + 1 = 0</span> " \
+                 "and <span data-math-style=\"display\">\\sum_i x_i</span>.</p>\n", html
+  end
+
+  def test_content_is_not_markdown
+    html = CommonMarker.render_html('$a_1 *b* < c_2$', :DEFAULT, %i[math])
+    assert_equal "<p><span data-math-style=\"inline\">a_1 *b* &lt; c_2</span></p>\n", html
+  end
+
+  def test_leaves_prices_and_escapes_alone
+    html = CommonMarker.render_html("It costs $5 or $10.\n\n\\$x$ `$y$` $$$$ $ z$", :DEFAULT, %i[math])
+    assert_equal "<p>It costs $5 or $10.</p>\n<p>$x$ <code>$y$</code> $$$$ $ z$</p>\n", html
+  end
+
+  def test_block
+    html = CommonMarker.render_html("$$\na < b\n\n*c*\n$$\nafter", :DEFAULT, %i[math])
+    assert_equal "<pre><code class=\"language-math\" data-math-style=\"display\">a &lt; b\n\n*c*\n</code></pre>\n" \
+                 "<p>after</p>\n", html
+  end
+
+  def test_block_in_containers
+    html = CommonMarker.render_html("> $$\n> x\n> $$\n\n- item\n\n  $$\n  y\n  $$\n", :DEFAULT, %i[math])
+    assert_equal "<blockquote>\n<pre><code class=\"language-math\" data-math-style=\"display\">x\n</code></pre>\n" \
+                 "</blockquote>\n<ul>\n<li>\n<p>item</p>\n" \
+                 "<pre><code class=\"language-math\" data-math-style=\"display\">y\n</code></pre>\n</li>\n</ul>\n", html
+  end
+
+  def test_delimiters_option
+    html = CommonMarker.render_html("$x$\n\n$$\ny\n$$", :MATH_DELIMITERS, %i[math])
+    assert_equal "<p><span data-math-style=\"inline\">$x$</span></p>\n" \
+                 "<pre><code class=\"language-math\" data-math-style=\"display\">$$\ny\n$$</code></pre>\n", html
+  end
+
+  def test_wrapper_attributes
+    attributes = CommonMarker::HtmlAttributes.new(math_inline: { class: 'math inline' },
+                                                  math_display: { class: 'math display' })
+    html = CommonMarker.render_html("$x$ $$y$$\n\n$$\nz\n$$", :DEFAULT, %i[math], attributes: attributes)
+    assert_equal "<p><span class=\"math inline\">x</span> <span class=\"math display\">y</span></p>\n" \
+                 "<pre><code class=\"math display\">z\n</code></pre>\n", html
+  end
+
+  def test_nodes
+    doc = CommonMarker.render_doc("$x$ $$y$$\n\n$$\nz\n$$", :DEFAULT, %i[math])
+    assert_equal %i[math_inline text math_display], doc.first_child.map(&:type)
+    assert_equal 'x', doc.first_child.first_child.string_content
+    assert_equal :math_block, doc.last_child.type
+    assert_equal "z\n", doc.last_child.string_content
+  end
+
+  def test_ruby_renderer_matches
+    doc = CommonMarker.render_doc("$x$ $$y$$\n\n$$\nz\n$$", :DEFAULT, %i[math])
+    [:DEFAULT, :MATH_DELIMITERS].each do |option|
+      assert_equal doc.to_html(option), CommonMarker::HtmlRenderer.new(options: option).render(doc)
+    end
+  end
+
+  def test_commonmark_roundtrip
+    md = "Inline $x$ and $$y$$.\n\n$$\nz\n$$\n"
+    assert_equal md, CommonMarker.render_doc(md, :DEFAULT, %i[math]).to_commonmark
+  end
+end
@@ -0,0 +1,63 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestMemoryProfile < Minitest::Test
+  def setup
+    @text = fixtures_file('dingus.md') * 20 + "\n\n| a |\n|---|\n| b |\n"
+    @profile = CommonMarker.memory_profile(@text, :DEFAULT, %i[table])
+  end
+
+  def test_counts_each_phase
+    assert_equal %i[blocks inlines postprocess render], @profile[:phases].keys
+    %i[blocks inlines render].each do |phase|
+      stats = @profile[:phases][phase]
+      assert_operator stats[:allocs], :>, 0, phase
+      assert_operator stats[:bytes], :>, 0, phase
+      assert_operator stats[:peak_live], :<=, @profile[:peak_live]
+    end
+  end
+
+  def test_everything_is_freed
+    phases = @profile[:phases].values
+    allocs = phases.sum { |stats| stats[:allocs] }
+    frees = phases.sum { |stats| stats[:frees] }
+    assert_equal allocs, frees
+  end
+
+  def test_peak_grows_with_the_input
+    bigger = CommonMarker.memory_profile(@text * 10, :DEFAULT, %i[table])
+    assert_operator bigger[:peak_live], :>, @profile[:peak_live] * 5
+  end
+
+  def test_node_types
+    types = @profile[:node_types]
+    assert_equal 1, types[:document][:count]
+    assert_equal 1, types[:table][:count]
+    assert_operator types[:text][:count], :>, types[:paragraph][:count]
+    assert(types.values.all? { |entry| entry[:bytes] >= entry[:count] * 64 })
+  end
+
+  def test_retained_tree
+    node_bytes = @profile[:node_types].values.sum { |entry| entry[:bytes] }
+    assert_operator @profile[:retained], :>=, node_bytes
+    assert_operator @profile[:retained], :<, @profile[:peak_live]
+  end
+
+  def test_literals_are_counted_by_length
+    profile = CommonMarker.memory_profile("#{'x' * 1000}\n\n```\n#{'y' * 5000}\n```\n")
+    assert_operator profile[:node_types][:code_block][:bytes], :>=, 5000
+  end
+
+  def test_output_allocation
+    output = @profile[:output]
+    assert_equal CommonMarker.render_html(@text, :DEFAULT, %i[table]), output[:html]
+    assert_equal output[:html].bytesize, output[:bytes]
+    assert_operator output[:allocated], :>, output[:bytes]
+  end
+
+  def test_rejects_unknown_extensions
+    assert_raises(ArgumentError) { CommonMarker.memory_profile('Hi', :DEFAULT, %i[bogus]) }
+    assert_raises(TypeError) { CommonMarker.memory_profile(nil) }
+  end
+end
@@ -0,0 +1,63 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestMentions < Minitest::Test
+  def setup
+    @markdown = <<~MD
+      Thanks @alice and @bob-, see #12 and @github/docs.
+
+      Not mentions: foo@example.com, a#1, @_x, `@alice #12`, [@alice](/x), @alice_b
+    MD
+    @urls = { '@alice' => 'https://github.com/alice', '#12' => '/issues/12', '@github/docs' => 'https://github.com/orgs/github/teams/docs' }
+  end
+
+  def test_resolves_candidates_in_one_batch
+    batches = []
+    html = CommonMarker.render_html(@markdown, :DEFAULT, %i[mention]) do |refs|
+      batches << refs
+      @urls
+    end
+
+    assert_equal [['@alice', '@bob', '#12', '@github/docs']], batches
+    assert_equal <<~HTML, html
+      <p>Thanks <a href="https://github.com/alice">@alice</a> and @bob-, see <a href="/issues/12">#12</a> and <a href="https://github.com/orgs/github/teams/docs">@github/docs</a>.</p>
+      <p>Not mentions: foo@example.com, a#1, @_x, <code>@alice #12</code>, <a href="/x">@alice</a>, @alice_b</p>
+    HTML
+  end
+
+  def test_unresolved_mentions_render_as_text
+    doc = CommonMarker.render_doc(@markdown, :DEFAULT, %i[mention])
+    mentions = doc.walk.select { |node| node.type == :mention }
+    assert_equal 4, mentions.length
+    assert_equal CommonMarker.render_html(@markdown), doc.to_html
+    assert_equal CommonMarker.render_html(@markdown), HtmlRenderer.new.render(doc)
+    assert_equal "Thanks @alice and @bob-, see #12 and @github/docs.\n", doc.first_child.to_plaintext
+  end
+
+  def test_resolve_mentions_on_node
+    doc = CommonMarker.render_doc(@markdown, :DEFAULT, %i[mention])
+    assert_same doc, doc.resolve_mentions { |_| { '@bob' => '/bob' } }
+    links = doc.walk.select { |node| node.type == :link }
+    assert_equal ['/bob', '/x'], links.map(&:url)
+    assert_equal 3, doc.walk.count { |node| node.type == :mention }
+  end
+
+  def test_bare_numbers_are_not_mentions
+    doc = CommonMarker.render_doc("123 apples\n\n12", :DEFAULT, %i[mention])
+    assert_equal 0, doc.walk.count { |node| node.type == :mention }
+  end
+
+  def test_no_block_call_without_candidates
+    called = false
+    CommonMarker.render_html('nothing here', :DEFAULT, %i[mention]) { called = true }
+    refute called
+  end
+
+  def test_bad_resolver_results
+    doc = CommonMarker.render_doc('@alice', :DEFAULT, %i[mention])
+    assert_raises(TypeError) { doc.resolve_mentions { |_| [] } }
+    assert_raises(TypeError) { doc.resolve_mentions { |_| { '@alice' => 1 } } }
+    assert_raises(LocalJumpError) { doc.resolve_mentions }
+  end
+end
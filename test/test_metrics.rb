@@ -0,0 +1,86 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestMetrics < Minitest::Test
+  def setup
+    CommonMarker.metrics(reset: true)
+    CommonMarker.metrics_enabled = true
+  end
+
+  def teardown
+    CommonMarker.metrics_enabled = false
+    CommonMarker.metrics(reset: true)
+  end
+
+  def series(operation, extensions = [])
+    CommonMarker.metrics[:series].select do |entry|
+      entry[:operation] == operation && entry[:extensions] == extensions
+    end
+  end
+
+  def test_off_by_default_records_nothing
+    CommonMarker.metrics_enabled = false
+    CommonMarker.render_html('*hi*')
+    assert_empty CommonMarker.metrics[:series]
+    refute CommonMarker.metrics_enabled?
+  end
+
+  def test_records_parse_and_render
+    3.times { CommonMarker.render_html('*hi*') }
+
+    %i[parse render].each do |operation|
+      entry = series(operation).first
+      assert_equal 3, entry[:count]
+      assert_equal 0, entry[:min_bytes]
+      assert_equal 256, entry[:max_bytes]
+      assert_operator entry[:max_ns], :<=, entry[:total_ns]
+      assert_equal 3, entry[:buckets].sum(&:last)
+      entry[:buckets].each do |min_ns, max_ns, _|
+        assert_operator min_ns, :<, max_ns
+      end
+    end
+  end
+
+  def test_buckets_by_input_size
+    CommonMarker.render_html('a')
+    CommonMarker.render_html('a' * 2000)
+    CommonMarker.render_html('a' * 2_000_000)
+
+    sizes = series(:parse).map { |entry| [entry[:min_bytes], entry[:max_bytes]] }
+    assert_equal [[0, 256], [1024, 4096], [1_048_576, nil]], sizes.sort_by(&:first)
+  end
+
+  def test_extension_sets_are_kept_apart_whatever_their_order
+    CommonMarker.render_html('a', :DEFAULT, %i[table autolink])
+    CommonMarker.render_html('a', :DEFAULT, %i[autolink table])
+    CommonMarker.render_html('a', :DEFAULT, %i[strikethrough])
+
+    assert_equal 2, series(:parse, %i[autolink table]).first[:count]
+    assert_equal 1, series(:parse, %i[strikethrough]).first[:count]
+    assert_empty series(:parse)
+  end
+
+  def test_renders_a_document_by_the_size_of_its_markdown
+    doc = CommonMarker.render_doc("# #{'a' * 2000}")
+    doc.to_html
+
+    assert_equal 1024, series(:render).first[:min_bytes]
+  end
+
+  def test_records_without_the_gvl
+    threads = Array.new(4) do
+      Thread.new { 25.times { CommonMarker::Node.markdown_to_html('*hi*', 0, [], nil, true) } }
+    end
+    threads.each(&:join)
+
+    assert_equal 100, series(:parse).first[:count]
+    assert_equal 100, series(:render).first[:count]
+  end
+
+  def test_reset
+    CommonMarker.render_html('*hi*')
+    refute_empty CommonMarker.metrics(reset: true)[:series]
+    assert_empty CommonMarker.metrics[:series]
+  end
+end
@@ -0,0 +1,30 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'open3'
+
+class TestProbes < Minitest::Test
+  PROBES = %w[
+    parse__feed__start parse__feed__done parse__finish__start parse__finish__done
+    inlines__start inlines__done postprocess__start postprocess__done
+    render__start render__done
+  ].freeze
+
+  def setup
+    skip 'built without <sys/sdt.h>' unless CommonMarker::PROBES
+
+    @library = $LOADED_FEATURES.find { |path| path.match?(%r{commonmarker/commonmarker\.(so|bundle)\z}) }
+    @notes, status = Open3.capture2('readelf', '--notes', @library)
+    skip 'readelf failed' unless status.success?
+  rescue Errno::ENOENT
+    skip 'readelf is not installed'
+  end
+
+  def test_probe_notes_are_in_the_library
+    probes = @notes.each_line.each_cons(2).filter_map do |provider, name|
+      name[/Name: (\S+)/, 1] if provider.include?('Provider: commonmarker')
+    end
+
+    PROBES.each { |probe| assert_includes probes, probe }
+  end
+end
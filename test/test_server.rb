@@ -0,0 +1,90 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'commonmarker/server'
+require 'tmpdir'
+
+class TestServer < Minitest::Test
+  def setup
+    @dir = Dir.mktmpdir
+    @path = File.join(@dir, 'commonmarker.sock')
+    @server = CommonMarker::Server.new(@path)
+    @thread = Thread.new { @server.run }
+  end
+
+  def teardown
+    @server.close
+    @thread.join
+    FileUtils.remove_entry(@dir)
+  end
+
+  def test_renders_documents
+    client = CommonMarker::Client.new(@path)
+    text = fixtures_file('table.md')
+
+    assert_equal CommonMarker.render_html(text), client.render_html(text)
+    assert_equal CommonMarker.render_html(text, :UNSAFE, %i[table strikethrough]),
+                 client.render_html(text, :UNSAFE, %i[table strikethrough])
+    assert_equal '', client.render_html('')
+    assert_equal Encoding::UTF_8, client.render_html('ünïcödé').encoding
+  ensure
+    client&.close
+  end
+
+  def test_reports_errors_and_keeps_going
+    client = CommonMarker::Client.new(@path)
+    error = assert_raises(CommonMarker::Client::Error) { client.render_html('Hi', :DEFAULT, %i[bogus]) }
+    assert_match 'extension bogus not found', error.message
+    assert_equal "<p>Hi</p>\n", client.render_html('Hi')
+  ensure
+    client&.close
+  end
+
+  def test_concurrent_clients
+    text = fixtures_file('dingus.md') * 100
+    expected = CommonMarker.render_html(text, :DEFAULT, %i[table autolink])
+
+    results = Array.new(4) do
+      Thread.new do
+        client = CommonMarker::Client.new(@path)
+        Array.new(5) { client.render_html(text, :DEFAULT, %i[table autolink]) }.tap { client.close }
+      end
+    end.flat_map(&:value)
+
+    assert_equal [expected] * 20, results
+  end
+
+  def test_extension_characters_are_per_parser
+    text = "~~gone~~ :smile: $x$ @someone\n" * 2000
+    sets = [%i[strikethrough], %i[emoji], %i[math], %i[mention], []]
+    expected = sets.map { |extensions| CommonMarker.render_html(text, :DEFAULT, extensions) }
+
+    results = Array.new(20) do |i|
+      Thread.new { Node.markdown_to_html(text, 0, sets[i % sets.length], nil, true) }
+    end.map(&:value)
+
+    assert_equal expected * 4, results
+  end
+
+  def test_replaces_stale_socket
+    @server.close
+    @thread.join
+    UNIXServer.new(@path).close # leaves the file behind
+
+    @server = CommonMarker::Server.new(@path)
+    @thread = Thread.new { @server.run }
+    assert_equal "<p>Hi</p>\n", CommonMarker::Client.new(@path).render_html('Hi')
+  end
+
+  def test_command
+    path = File.join(@dir, 'cli.sock')
+    pid = spawn('ruby', 'bin/commonmarker', 'serve', "--socket=#{path}")
+    50.times { break if File.socket?(path); sleep 0.1 } # rubocop:disable Style/Semicolon
+
+    out = `ruby bin/commonmarker client --socket=#{path} --extension=table #{File.join(FIXTURES_DIR, 'table.md')}`
+    assert_includes out, '<table>'
+  ensure
+    Process.kill('TERM', pid)
+    Process.wait(pid)
+  end
+end
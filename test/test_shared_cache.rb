@@ -0,0 +1,82 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestSharedCache < Minitest::Test
+  def setup
+    @cache = CommonMarker::SharedCache.new(1 << 20)
+    CommonMarker.shared_cache = @cache
+  end
+
+  def teardown
+    CommonMarker.shared_cache = nil
+  end
+
+  def test_hits_after_first_render
+    first = CommonMarker.render_html("Hello *world*\n")
+    second = CommonMarker.render_html("Hello *world*\n")
+
+    assert_equal "<p>Hello <em>world</em></p>\n", second
+    assert_equal first, second
+    assert_equal Encoding::UTF_8, second.encoding
+    assert_equal 1, @cache.stats[:hits]
+    assert_equal 1, @cache.stats[:misses]
+    assert_equal 1, @cache.stats[:stores]
+  end
+
+  def test_fetch_only_yields_on_miss
+    calls = 0
+    2.times { @cache.fetch('text', 0, []) { calls += 1; 'html' } }
+    assert_equal 1, calls
+    assert_equal 'html', @cache.fetch('text', 0, []) { flunk }
+  end
+
+  def test_options_and_extensions_are_part_of_the_key
+    text = "| a |\n|---|\n| \"b\" |\n"
+    plain = CommonMarker.render_html(text)
+    table = CommonMarker.render_html(text, :DEFAULT, %i[table])
+    smart = CommonMarker.render_html(text, :SMART, %i[table])
+
+    refute_equal plain, table
+    refute_equal table, smart
+    assert_equal table, CommonMarker.render_html(text, :DEFAULT, %i[table])
+    assert_equal 1, @cache.stats[:hits]
+  end
+
+  def test_resolver_and_attributes_skip_the_cache
+    CommonMarker.render_html('Hi', :DEFAULT, [], attributes: CommonMarker::HtmlAttributes.new(paragraph: { class: 'x' }))
+    assert_equal 0, @cache.stats[:misses]
+  end
+
+  def test_oldest_entries_are_evicted
+    cache = CommonMarker::SharedCache.new(64 * 1024)
+    200.times { |i| cache.fetch("doc #{i}", 0, []) { 'x' * 1000 } }
+
+    assert_equal 'fresh', cache.fetch('doc 0', 0, []) { 'fresh' }
+    assert_equal 'x' * 1000, cache.fetch('doc 199', 0, []) { flunk }
+    assert_operator cache.stats[:written], :>, cache.stats[:capacity]
+  end
+
+  def test_oversized_entries_are_not_stored
+    cache = CommonMarker::SharedCache.new(64 * 1024)
+    cache.fetch('big', 0, []) { 'x' * 32 * 1024 }
+    assert_equal 0, cache.stats[:stores]
+  end
+
+  def test_entries_are_shared_across_fork
+    skip 'fork is unavailable' unless Process.respond_to?(:fork)
+
+    pid = fork { CommonMarker.render_html("From the *child*\n") }
+    _, status = Process.wait2(pid)
+    assert_predicate status, :success?
+
+    CommonMarker.render_html("From the *child*\n")
+    assert_equal 1, @cache.stats[:hits]
+  end
+
+  def test_rejects_bad_arguments
+    assert_raises(ArgumentError) { CommonMarker::SharedCache.new(0) }
+    assert_raises(TypeError) { @cache.fetch('x', 0, ['table']) { '' } }
+    assert_raises(LocalJumpError) { @cache.fetch('x', 0, []) }
+  end
+end
@@ -0,0 +1,102 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+require 'json'
+require 'tmpdir'
+
+class TestSlowInputs < Minitest::Test
+  def teardown
+    CommonMarker.capture_slow_inputs(threshold: nil)
+  end
+
+  def test_nothing_is_kept_by_default
+    CommonMarker.render_html('*hi*')
+    assert_empty CommonMarker.slow_inputs
+  end
+
+  def test_keeps_inputs_over_the_threshold
+    CommonMarker.capture_slow_inputs(threshold: 0)
+    CommonMarker.render_html('*hi*', :DEFAULT, %i[table])
+
+    input = CommonMarker.slow_inputs.first
+    assert_equal '*hi*', input[:input]
+    assert_equal 4, input[:input_bytes]
+    refute input[:truncated]
+    assert_match(/\A\h{16}\z/, input[:digest])
+    assert_equal 0, input[:options]
+    assert_equal %i[table], input[:extensions]
+    assert_operator input[:parse_ns], :>, 0
+    assert_operator input[:render_ns], :>, 0
+    refute input[:timed_out]
+    assert_kind_of Time, input[:at]
+    assert_in_delta Time.now, input[:at], 60
+  end
+
+  def test_fast_inputs_are_not_kept
+    CommonMarker.capture_slow_inputs(threshold: 60)
+    CommonMarker.render_html('*hi*')
+    CommonMarker.render_doc('*hi*')
+    assert_empty CommonMarker.slow_inputs
+  end
+
+  def test_keeps_parse_only_inputs
+    CommonMarker.capture_slow_inputs(threshold: 0)
+    CommonMarker.render_doc('*hi*')
+    assert_nil CommonMarker.slow_inputs.first[:render_ns]
+  end
+
+  def test_keeps_inputs_that_time_out
+    CommonMarker.capture_slow_inputs(threshold: 60)
+    deadline = Process.clock_gettime(Process::CLOCK_MONOTONIC, :nanosecond) - 1
+    assert_raises(CommonMarker::Timeout) { CommonMarker.render_html('*hi*' * 1000, deadline: deadline) }
+
+    assert CommonMarker.slow_inputs.first[:timed_out]
+  end
+
+  def test_keeps_inputs_whose_parse_times_out
+    CommonMarker.capture_slow_inputs(threshold: 60)
+    deadline = Process.clock_gettime(Process::CLOCK_MONOTONIC, :nanosecond) - 1
+    assert_raises(CommonMarker::Timeout) { CommonMarker.render_doc('*hi*' * 1000, deadline: deadline) }
+
+    assert_equal '*hi*' * 1000, CommonMarker.slow_inputs.first[:input]
+  end
+
+  def test_keeps_inputs_rendered_without_the_gvl
+    CommonMarker.capture_slow_inputs(threshold: 0)
+    CommonMarker::Node.markdown_to_html('*hi*', 0, [], nil, true)
+    assert_equal '*hi*', CommonMarker.slow_inputs.first[:input]
+  end
+
+  def test_truncates_at_a_character_boundary
+    CommonMarker.capture_slow_inputs(threshold: 0, max_bytes: 4)
+    CommonMarker.render_html('aaé and more')
+
+    input = CommonMarker.slow_inputs.first
+    assert_equal 'aaé', input[:input]
+    assert input[:truncated]
+    assert_equal 'aaé and more'.bytesize, input[:input_bytes]
+  end
+
+  def test_keeps_only_the_latest
+    CommonMarker.capture_slow_inputs(threshold: 0, capacity: 3)
+    5.times { |i| CommonMarker.render_html(i.to_s) }
+
+    assert_equal %w[2 3 4], CommonMarker.slow_inputs.map { |input| input[:input] }
+    assert_equal %w[2 3 4], CommonMarker.slow_inputs(clear: true).map { |input| input[:input] }
+    assert_empty CommonMarker.slow_inputs
+  end
+
+  def test_dumps_json_lines
+    CommonMarker.capture_slow_inputs(threshold: 0)
+    CommonMarker.render_html('*hi*', :DEFAULT, %i[autolink])
+
+    Dir.mktmpdir do |dir|
+      path = File.join(dir, 'slow.jsonl')
+      assert_equal 1, CommonMarker.dump_slow_inputs(path)
+
+      input = JSON.parse(File.read(path))
+      assert_equal '*hi*', input['input']
+      assert_equal ['autolink'], input['extensions']
+    end
+  end
+end
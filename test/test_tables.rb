@@ -0,0 +1,53 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestTables < Minitest::Test
+  def setup
+    @markdown = <<~MD
+      Some text.
+
+      | a | b `c` | d |
+      |:--|:-----:|--:|
+      | *e* | f<br>g | ~~h~~ |
+      | i |
+
+      | x |
+      |---|
+      | y |
+    MD
+    @doc = CommonMarker.render_doc(@markdown, :UNSAFE, %i[table strikethrough])
+  end
+
+  def test_tables_as_plaintext
+    tables = @doc.tables
+
+    assert_equal 2, tables.length
+    assert_equal({ alignments: %i[left center right], header: ['a', 'b c', 'd'], rows: [['e', 'fg', 'h'], ['i', '', '']] }, tables[0])
+    assert_equal({ alignments: [nil], header: ['x'], rows: [['y']] }, tables[1])
+  end
+
+  def test_tables_as_html
+    tables = @doc.tables(:html, :UNSAFE)
+
+    assert_equal ['a', 'b <code>c</code>', 'd'], tables[0][:header]
+    assert_equal ['<em>e</em>', 'f<br>g', '<del>h</del>'], tables[0][:rows][0]
+    assert_equal Encoding::UTF_8, tables[0][:rows][0][0].encoding
+  end
+
+  def test_tables_on_subtree
+    assert_empty @doc.first_child.tables
+    assert_equal 1, @doc.first_child.next.tables.length
+  end
+
+  def test_extract_tables
+    assert_equal @doc.tables, CommonMarker.extract_tables(@markdown, :DEFAULT, %i[strikethrough])
+    assert_equal @doc.tables(:html, :UNSAFE), CommonMarker.extract_tables(@markdown, :UNSAFE, %i[strikethrough], :html)
+    assert_empty CommonMarker.extract_tables('no tables here')
+  end
+
+  def test_bad_format
+    assert_raises(TypeError) { @doc.tables(:xml) }
+    assert_raises(TypeError) { CommonMarker.extract_tables(@markdown, :DEFAULT, [], :xml) }
+  end
+end
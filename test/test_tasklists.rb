@@ -33,6 +33,25 @@ class TestTasklists < Minitest::Test
     refute list.first_child.next.tasklist_item_checked?
   end
 
+  def test_tasklist_summary
+    text = <<~MD
+      - [x] Done
+      - [ ] Todo *with* `inlines`
+        - [X] Nested
+        - Not a task
+
+      1. [ ] Ordered
+
+      ```
+      - [x] Code
+      ```
+    MD
+    summary = CommonMarker.tasklist_summary(text)
+    assert_equal({ total: 4, checked: 2, items: [[1, true], [2, false], [3, true], [6, false]] }, summary)
+    assert_equal({ total: 0, checked: 0, items: [] }, CommonMarker.tasklist_summary('- item'))
+    assert_raises(TypeError) { CommonMarker.tasklist_summary(nil) }
+  end
+
   def test_set_tasklist_state
     list = @doc.first_child
     list.first_child.tasklist_item_checked = false
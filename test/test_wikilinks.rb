@@ -0,0 +1,70 @@
+# frozen_string_literal: true
+
+require 'test_helper'
+
+class TestWikilinks < Minitest::Test
+  def setup
+    @markdown = <<~MD
+      See [[Home]], [[ Road map | our *plans* ]] and [[Home|the start]].
+
+      Not wikilinks: `[[Home]]`, [[a
+      b]], [[|x]], [[x|]], [[a]b]], [link [[Home]]](/x)
+    MD
+  end
+
+  def test_renders_links
+    html = CommonMarker.render_html('See [[Home]] and [[Road map|our plans]].', :DEFAULT, %i[wikilink])
+    assert_equal "<p>See <a href=\"Home\" class=\"wikilink\">Home</a> and " \
+                 "<a href=\"Road%20map\" class=\"wikilink\">our plans</a>.</p>\n", html
+  end
+
+  def test_nodes
+    doc = CommonMarker.render_doc(@markdown, :DEFAULT, %i[wikilink])
+    wikilinks = doc.walk.select { |node| node.type == :wikilink }
+    assert_equal ['Home', 'Road map', 'Home'], wikilinks.map(&:wikilink_target)
+    assert_equal ['Home', 'our *plans*', 'the start'], wikilinks.map { |node| node.first_child.string_content }
+    assert_raises(NodeError) { doc.wikilink_target }
+  end
+
+  def test_resolves_targets_in_one_batch
+    calls = []
+    doc = CommonMarker.render_doc(@markdown, :DEFAULT, %i[wikilink])
+    assert_same doc, doc.resolve_wikilinks { |targets| calls << targets; Set['Home'] }
+    assert_equal [['Home', 'Road map']], calls
+    assert_equal [false, true, false], doc.walk.select { |node| node.type == :wikilink }.map(&:wikilink_missing?)
+
+    html = doc.to_html
+    assert_includes html, '<a href="Road%20map" class="wikilink wikilink-missing">our *plans*</a>'
+    assert_equal html, HtmlRenderer.new.render(doc)
+  end
+
+  def test_render_html_resolves_targets
+    calls = []
+    lookup = ->(targets) { calls << targets; ['Home'] }
+    html = CommonMarker.render_html(@markdown, :DEFAULT, %i[wikilink mention], wikilinks: lookup) { {} }
+    assert_equal [['Home', 'Road map']], calls
+    assert_includes html, '<a href="Home" class="wikilink">Home</a>'
+    assert_includes html, '<a href="Road%20map" class="wikilink wikilink-missing">our *plans*</a>'
+  end
+
+  def test_no_block_call_without_wikilinks
+    called = false
+    CommonMarker.render_doc('[[ ]] [x]', :DEFAULT, %i[wikilink]).resolve_wikilinks { called = true }
+    refute called
+  end
+
+  def test_unsafe_targets
+    html = CommonMarker.render_html('[[javascript:alert(1)]]', :DEFAULT, %i[wikilink])
+    assert_equal "<p><a href=\"\" class=\"wikilink\">javascript:alert(1)</a></p>\n", html
+  end
+
+  def test_commonmark_roundtrip
+    md = "[[Home]] and [[Road map|plans]]\n"
+    assert_equal md, CommonMarker.render_doc(md, :DEFAULT, %i[wikilink]).to_commonmark
+  end
+
+  def test_links_still_work
+    html = CommonMarker.render_html("[a] [b][] [[c]]\n\n[a]: /a\n[b]: /b", :DEFAULT, %i[wikilink])
+    assert_equal "<p><a href=\"/a\">a</a> <a href=\"/b\">b</a> <a href=\"c\" class=\"wikilink\">c</a></p>\n", html
+  end
+end